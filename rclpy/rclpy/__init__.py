@@ -52,7 +52,7 @@ def shutdown(*, context=None):
 
 def create_node(
     node_name, *, context=None, cli_args=None, namespace=None, use_global_arguments=True,
-    start_parameter_services=True, initial_parameters=None
+    start_parameter_services=True, initial_parameters=None, parameter_event_window_sec=None
 ):
     """
     Create an instance of :class:`rclpy.node.Node`.
@@ -64,6 +64,9 @@ def create_node(
     :param use_global_arguments: False if the node should ignore process-wide command line args.
     :param start_parameter_services: False if the node should not create parameter services.
     :param initial_parameters: A list of rclpy.parameter.Parameters to be set during node creation.
+    :param parameter_event_window_sec: If not None, the period in seconds over which parameter
+        changes are collected into a single parameter event. Otherwise an event is published for
+        each call that sets parameters.
     :return: An instance of a node
     :rtype: :class:`rclpy.node.Node`
     """
@@ -73,7 +76,8 @@ def create_node(
         node_name, context=context, cli_args=cli_args, namespace=namespace,
         use_global_arguments=use_global_arguments,
         start_parameter_services=start_parameter_services,
-        initial_parameters=initial_parameters)
+        initial_parameters=initial_parameters,
+        parameter_event_window_sec=parameter_event_window_sec)
 
 
 def spin_once(node, *, executor=None, timeout_sec=None):
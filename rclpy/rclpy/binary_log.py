@@ -0,0 +1,150 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Decoder of the binary log files written by :func:`rclpy.logging.enable_binary_output`.
+
+Run ``python3 -m rclpy.binary_log <file>`` to print a file as text.
+"""
+
+import argparse
+from collections import namedtuple
+import struct
+import sys
+
+MAGIC = b'RCLPYLOG'
+VERSION = 1
+
+# Layouts of the structs of _rclpy_logging.c, without the byte order
+_HEADER_FORMAT = '8sII9Q'
+_ENTRY_FORMAT = '4I'
+_RECORD_FORMAT = '3I2Hq'
+
+_ENTRY_LOGGER_NAME = 1
+_ENTRY_LOCATION = 2
+
+_SEVERITY_NAMES = {10: 'DEBUG', 20: 'INFO', 30: 'WARN', 40: 'ERROR', 50: 'FATAL'}
+
+BinaryLogRecord = namedtuple('BinaryLogRecord', [
+    'timestamp', 'severity', 'name', 'function_name', 'file_name', 'line_number', 'message'])
+BinaryLogRecord.__doc__ = """
+A log message read from a binary log file.
+
+The timestamp is in nanoseconds since the epoch. Names and locations that did not fit in the
+file are ``None``.
+"""
+
+
+def read_binary_log(path):
+    """
+    Read the log messages of a binary log file, oldest first.
+
+    :param path: Path of the file.
+    :returns: list of :class:`BinaryLogRecord`.
+    :raises ValueError: if the file is not a binary log file.
+    """
+    with open(path, 'rb') as f:
+        data = f.read()
+    return decode_binary_log(data)
+
+
+def decode_binary_log(data):
+    """Decode the content of a binary log file, see :func:`read_binary_log`."""
+    if len(data) < struct.calcsize('<' + _HEADER_FORMAT) or not data.startswith(MAGIC):
+        raise ValueError('Not a binary log file')
+    for byte_order in '<>':
+        if struct.unpack_from(byte_order + 'I', data, 12)[0] == 0x01020304:
+            break
+    else:
+        raise ValueError('Unknown byte order of binary log file')
+    header_struct = struct.Struct(byte_order + _HEADER_FORMAT)
+    entry_struct = struct.Struct(byte_order + _ENTRY_FORMAT)
+    record_struct = struct.Struct(byte_order + _RECORD_FORMAT)
+
+    (_, version, _, strings_offset, _, strings_used, ring_offset, ring_size,
+     _, tail, used, _) = header_struct.unpack_from(data, 0)
+    if version != VERSION:
+        raise ValueError('Unsupported binary log file version {}'.format(version))
+
+    names = {}
+    locations = {}
+    offset = strings_offset
+    while offset < strings_offset + strings_used:
+        size, id_, kind, line_number = entry_struct.unpack_from(data, offset)
+        strings = data[offset + entry_struct.size:offset + size].split(b'\0')
+        if kind == _ENTRY_LOGGER_NAME:
+            names[id_] = strings[0].decode(errors='replace')
+        elif kind == _ENTRY_LOCATION:
+            locations[id_] = (
+                strings[0].decode(errors='replace'), strings[1].decode(errors='replace'),
+                line_number)
+        offset += size
+
+    records = []
+    position = tail
+    consumed = 0
+    while consumed < used:
+        offset = ring_offset + position
+        size = struct.unpack_from(byte_order + 'I', data, offset)[0]
+        if size == 0:
+            # The rest of the ring is unused
+            consumed += ring_size - position
+            position = 0
+            continue
+        _, name_id, location_id, severity, message_size, timestamp = \
+            record_struct.unpack_from(data, offset)
+        message_offset = offset + record_struct.size
+        function_name, file_name, line_number = locations.get(location_id, (None, None, None))
+        records.append(BinaryLogRecord(
+            timestamp=timestamp, severity=severity, name=names.get(name_id),
+            function_name=function_name, file_name=file_name, line_number=line_number,
+            message=data[message_offset:message_offset + message_size].decode(
+                errors='replace')))
+        consumed += size
+        position += size
+        if position == ring_size:
+            position = 0
+    return records
+
+
+def format_record(record, *, location=False):
+    """Format a log message like the console output of rcutils does by default."""
+    text = '[{}] [{}.{:09d}] [{}]: {}'.format(
+        _SEVERITY_NAMES.get(record.severity, record.severity),
+        record.timestamp // 10**9, record.timestamp % 10**9,
+        '?' if record.name is None else record.name, record.message)
+    if location and record.file_name is not None:
+        text += ' ({}() at {}:{})'.format(
+            record.function_name, record.file_name, record.line_number)
+    return text
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description='Print a binary log file as text.')
+    parser.add_argument('path', help='Path of the binary log file')
+    parser.add_argument(
+        '--location', action='store_true', help='Print where the messages were logged')
+    args = parser.parse_args(argv)
+    try:
+        records = read_binary_log(args.path)
+    except (OSError, ValueError) as e:
+        print(str(e), file=sys.stderr)
+        return 1
+    for record in records:
+        print(format_record(record, location=args.location))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
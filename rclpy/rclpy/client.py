@@ -12,17 +12,107 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import heapq
 import threading
 import time
+import weakref
 
+from rclpy.constants import S_TO_NS
 from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 from rclpy.task import Future
+from rclpy.utilities import timeout_sec_to_nsec
+
+# Longest time blocking calls sleep before checking that the context is still valid
+_MAX_WAIT_SEC = 1.0
+
+# Rebuild the deadline heap when it holds this many more entries than pending requests
+_DEADLINE_HEAP_SLACK = 64
+
+# Graph waiters in use, keyed by node handle
+_graph_waiters = {}
+_graph_waiters_lock = threading.Lock()
+
+
+class _GraphWaiter:
+    """
+    Wait on the graph guard condition of a node on behalf of several threads.
+
+    A guard condition can't be in several wait sets at once with some middlewares, so one of the
+    waiting threads waits on it while the others sleep on a condition variable, and are woken up
+    to check their own predicate each time the wait returns.
+    """
+
+    def __init__(self, node_handle):
+        self._node_handle = node_handle
+        self._condition = threading.Condition()
+        # True while a thread waits on the guard condition
+        self._waiting = False
+        self._wait_set = None
+        # Number of threads using the waiter
+        self._users = 0
+
+    @classmethod
+    def acquire(cls, node_handle):
+        with _graph_waiters_lock:
+            waiter = _graph_waiters.get(node_handle)
+            if waiter is None:
+                waiter = cls(node_handle)
+                _graph_waiters[node_handle] = waiter
+            waiter._users += 1
+            return waiter
+
+    @classmethod
+    def release(cls, node_handle):
+        with _graph_waiters_lock:
+            waiter = _graph_waiters[node_handle]
+            waiter._users -= 1
+            if waiter._users:
+                return
+            del _graph_waiters[node_handle]
+        # No other thread can get the waiter anymore
+        if waiter._wait_set is not None:
+            _rclpy.rclpy_destroy_wait_set(waiter._wait_set)
+            waiter._wait_set = None
+
+    def wait_until(self, predicate, context, deadline):
+        """Wait until the predicate is true, the context is shut down or the deadline passed."""
+        with self._condition:
+            while context.ok() and not predicate():
+                remaining = deadline - time.monotonic()
+                if remaining <= 0.0:
+                    return
+                if self._waiting:
+                    # Woken up when the wait on the guard condition returns
+                    self._condition.wait(min(remaining, _MAX_WAIT_SEC))
+                    continue
+                self._waiting = True
+                self._condition.release()
+                try:
+                    self._wait_graph_change(min(remaining, _MAX_WAIT_SEC))
+                finally:
+                    self._condition.acquire()
+                    self._waiting = False
+                    self._condition.notify_all()
+
+    def _wait_graph_change(self, timeout_sec):
+        # Only called by the thread which set _waiting
+        if self._wait_set is None:
+            wait_set = _rclpy.rclpy_get_zero_initialized_wait_set()
+            _rclpy.rclpy_wait_set_init(wait_set, 0, 1, 0, 0, 0)
+            self._wait_set = wait_set
+        graph_gc = _rclpy.rclpy_get_graph_guard_condition(self._node_handle)
+        _rclpy.rclpy_wait_set_clear_entities(self._wait_set)
+        _rclpy.rclpy_wait_set_add_entity('guard_condition', self._wait_set, graph_gc)
+        # Wake up regularly to notice shutdown, the sigint guard condition can't be shared with
+        # an executor spinning in another thread
+        _rclpy.rclpy_wait(self._wait_set, timeout_sec_to_nsec(timeout_sec))
 
 
 class Client:
     def __init__(
             self, node_handle, context, client_handle, client_pointer,
-            srv_type, srv_name, qos_profile, callback_group):
+            srv_type, srv_name, qos_profile, callback_group, *, node=None,
+            request_timeout_sec=None):
         self.node_handle = node_handle
         self.context = context
         self.client_handle = client_handle
@@ -32,33 +122,121 @@ class Client:
         self.qos_profile = qos_profile
         # Key is a sequence number, value is an instance of a Future
         self._pending_requests = {}
+        # Key is a Future, value is its sequence number
+        self._sequence_numbers = {}
+        # Heap of (deadline, sequence number) of requests which time out
+        self._deadlines = []
+        # Timer expiring requests at the earliest deadline, created on first use
+        self._expiry_timer = None
+        self._expiry_scheduled_at = None
+        # Protects the deadlines, the expiry timer and the early responses, which are used by
+        # callers and the executor
+        self._lock = threading.RLock()
+        # Number of call_async_many() sending requests not registered as pending yet
+        self._sends_in_progress = 0
+        # Responses taken while call_async_many() was sending, keyed by sequence number
+        self._early_responses = {}
+        # Timeout applied by call_async() when none is given
+        self.request_timeout_sec = request_timeout_sec
         self.callback_group = callback_group
         # True when the callback is ready to fire but has not been "taken" by an executor
         self._executor_event = False
+        # Guard conditions, or events when an executor takes the responses, of the threads
+        # blocked in call(), keyed by sequence number
+        self._sync_waiters = {}
+        # Wait sets and guard conditions ready to be reused by call()
+        self._sync_waiter_pool = []
+        # Held by the thread of call() waiting on the client
+        self._sync_wait_lock = threading.Lock()
+        self._node_weakref = weakref.ref(node) if node is not None else None
 
-    def call(self, req):
+    def call(self, req, timeout_sec=None):
         """
         Make a service request and wait for the result.
 
-        Do not call this method in a callback or a deadlock may occur.
+        If the node of the client was added to an executor, the executor takes the response, so
+        it must be spinning in another thread. Otherwise the response is waited for and taken
+        directly on the client, by one calling thread at a time. The client is never in two wait
+        sets at once, which some middlewares don't allow.
 
         :param req: The service request
+        :param timeout_sec: Seconds to wait. Block forever if None or negative.
+        :type timeout_sec: float or None
         :return: The service response
+        :raises TimeoutError: if no response arrived in time. The request is abandoned.
+        :raises RuntimeError: if the context was shut down while waiting.
         """
-        event = threading.Event()
-
-        def unblock(future):
-            nonlocal event
-            event.set()
+        deadline = None
+        if timeout_sec is not None and timeout_sec >= 0:
+            deadline = time.monotonic() + timeout_sec
 
-        future = self.call_async(req)
-        future.add_done_callback(unblock)
+        sequence_number, future = self._send_request(req, None)
+        node = self._node_weakref() if self._node_weakref is not None else None
+        if node is not None and node.executor is not None:
+            self._wait_for_executor(sequence_number, future, deadline)
+        else:
+            self._wait_and_take(sequence_number, future, deadline)
 
-        event.wait()
+        if not future.done():
+            self.remove_pending_request(future)
+            if not self.context.ok():
+                raise RuntimeError('Context was shut down while waiting for a response')
+            raise TimeoutError(
+                'No response from service {} after {} seconds'.format(self.srv_name, timeout_sec))
         if future.exception() is not None:
             raise future.exception()
         return future.result()
 
+    def _wait_remaining_sec(self, deadline):
+        wait_sec = _MAX_WAIT_SEC
+        if deadline is not None:
+            wait_sec = min(wait_sec, deadline - time.monotonic())
+        return wait_sec
+
+    def _wait_for_executor(self, sequence_number, future, deadline):
+        # Set by _set_response() in the thread of the executor, a done callback would only run
+        # once the executor gets to its task
+        event = threading.Event()
+        self._sync_waiters[sequence_number] = event
+        try:
+            while not future.done() and self.context.ok():
+                wait_sec = self._wait_remaining_sec(deadline)
+                if wait_sec <= 0.0:
+                    break
+                event.wait(wait_sec)
+        finally:
+            del self._sync_waiters[sequence_number]
+
+    def _wait_and_take(self, sequence_number, future, deadline):
+        try:
+            wait_set, guard = self._sync_waiter_pool.pop()
+        except IndexError:
+            wait_set = _rclpy.rclpy_get_zero_initialized_wait_set()
+            _rclpy.rclpy_wait_set_init(wait_set, 0, 1, 0, 1, 0)
+            guard, _ = _rclpy.rclpy_create_guard_condition(self.context.handle)
+        self._sync_waiters[sequence_number] = guard
+        try:
+            while not future.done() and self.context.ok():
+                wait_sec = self._wait_remaining_sec(deadline)
+                if wait_sec <= 0.0:
+                    break
+                # The thread waiting on the client takes the responses of the others too
+                if not self._sync_wait_lock.acquire(timeout=wait_sec):
+                    continue
+                try:
+                    if future.done():
+                        break
+                    seq_and_response = _rclpy.rclpy_wait_and_take_response(
+                        self.client_handle, self.srv_type.Response, wait_set, guard,
+                        timeout_sec_to_nsec(max(0.0, self._wait_remaining_sec(deadline))))
+                finally:
+                    self._sync_wait_lock.release()
+                if seq_and_response is not None:
+                    self._set_response(*seq_and_response)
+        finally:
+            del self._sync_waiters[sequence_number]
+            self._sync_waiter_pool.append((wait_set, guard))
+
     def remove_pending_request(self, future):
         """
         Remove a future from the list of pending requests.
@@ -67,43 +245,217 @@ class Client:
         :param future: a future returned from :meth:`call_async`
         :type future: rclpy.task.Future
         """
-        for seq, req_future in self._pending_requests.items():
-            if future == req_future:
-                try:
-                    del self._pending_requests[seq]
-                except KeyError:
-                    pass
-                break
+        sequence_number = self._sequence_numbers.pop(future, None)
+        if sequence_number is not None:
+            self._pending_requests.pop(sequence_number, None)
 
-    def call_async(self, req):
+    def call_async(self, req, timeout_sec=None):
         """
         Make a service request and asyncronously get the result.
 
+        :param req: The service request
+        :param timeout_sec: Seconds after which the future fails with :class:`TimeoutError` if no
+            response arrived. Defaults to the ``request_timeout_sec`` of the client, ``None``
+            waits forever. Expiry is done by a timer, so it requires spinning the node.
+        :type timeout_sec: float or None
         :return: a Future instance that completes when the request does
         :rtype: :class:`rclpy.task.Future` instance
         """
+        if timeout_sec is None:
+            timeout_sec = self.request_timeout_sec
+        _, future = self._send_request(req, timeout_sec)
+        return future
+
+    def call_async_many(self, requests, timeout_sec=None):
+        """
+        Make a batch of service requests and asyncronously get the results.
+
+        The requests are converted and sent in a single call into the C extension, which is
+        much cheaper than calling :meth:`call_async` for each of them.
+
+        :param requests: The service requests, all of the same type.
+        :param timeout_sec: Same as for :meth:`call_async`, applied to each request.
+        :type timeout_sec: float or None
+        :return: a Future instance per request, in order, completing as responses arrive. If
+            sending stopped on an error, the futures of the requests which were not sent fail
+            with a :class:`RuntimeError`.
+        :rtype: list of :class:`rclpy.task.Future` instances
+        :raises RuntimeError: if none of the requests could be sent.
+        """
+        if timeout_sec is None:
+            timeout_sec = self.request_timeout_sec
+        # The GIL is released while sending, so responses can be taken before the requests are
+        # registered as pending: keep them until then
+        with self._lock:
+            self._sends_in_progress += 1
+        early_responses = []
+        try:
+            sequence_numbers, error = _rclpy.rclpy_send_requests(self.client_handle, requests)
+            deadline = None if timeout_sec is None else time.monotonic() + timeout_sec
+            with self._lock:
+                futures = [self._add_pending_request(seq, deadline) for seq in sequence_numbers]
+                for seq in sequence_numbers:
+                    if seq in self._early_responses:
+                        early_responses.append((seq, self._early_responses.pop(seq)))
+        finally:
+            with self._lock:
+                self._sends_in_progress -= 1
+                if not self._sends_in_progress:
+                    self._early_responses.clear()
+        for seq, response in early_responses:
+            self._set_response(seq, response)
+        if error is not None:
+            if not futures:
+                raise RuntimeError(error)
+            # The requests which were sent keep their futures so their responses are matched
+            for _ in range(len(futures), len(requests)):
+                future = Future()
+                future.set_exception(RuntimeError(error))
+                futures.append(future)
+        return futures
+
+    def _send_request(self, req, timeout_sec):
         sequence_number = _rclpy.rclpy_send_request(self.client_handle, req)
+        deadline = None if timeout_sec is None else time.monotonic() + timeout_sec
+        return sequence_number, self._add_pending_request(sequence_number, deadline)
+
+    def _add_pending_request(self, sequence_number, deadline):
         if sequence_number in self._pending_requests:
             raise RuntimeError('Sequence (%r) conflicts with pending request' % sequence_number)
 
         future = Future()
         self._pending_requests[sequence_number] = future
+        self._sequence_numbers[future] = sequence_number
+        if deadline is not None:
+            self._add_deadline(deadline, sequence_number)
 
         future.add_done_callback(self.remove_pending_request)
 
         return future
 
+    def _add_deadline(self, deadline, sequence_number):
+        with self._lock:
+            if len(self._deadlines) > 2 * len(self._pending_requests) + _DEADLINE_HEAP_SLACK:
+                # Drop the deadlines of requests which already completed
+                self._deadlines = [
+                    entry for entry in self._deadlines if entry[1] in self._pending_requests]
+                heapq.heapify(self._deadlines)
+            heapq.heappush(self._deadlines, (deadline, sequence_number))
+            if self._expiry_scheduled_at is None or deadline < self._expiry_scheduled_at:
+                self._schedule_expiry()
+
+    def _schedule_expiry(self):
+        if not self._deadlines:
+            self._expiry_scheduled_at = None
+            if self._expiry_timer is not None:
+                self._expiry_timer.cancel()
+            return
+        deadline = self._deadlines[0][0]
+        delay_sec = max(0.0, deadline - time.monotonic())
+        if self._expiry_timer is None:
+            node = self._node_weakref() if self._node_weakref is not None else None
+            if node is None:
+                raise RuntimeError('Request timeouts need a client created by a node')
+            self._expiry_timer = node.create_timer(
+                delay_sec, self._expire_requests, callback_group=self.callback_group)
+        else:
+            self._expiry_timer.timer_period_ns = int(delay_sec * S_TO_NS)
+            self._expiry_timer.reset()
+        self._expiry_scheduled_at = deadline
+
+    def _expire_requests(self):
+        expired = []
+        with self._lock:
+            now = time.monotonic()
+            while self._deadlines and self._deadlines[0][0] <= now:
+                _, sequence_number = heapq.heappop(self._deadlines)
+                future = self._pending_requests.pop(sequence_number, None)
+                if future is not None:
+                    expired.append((sequence_number, future))
+            self._schedule_expiry()
+        for sequence_number, future in expired:
+            self._sequence_numbers.pop(future, None)
+            self._bind_executor(future)
+            future.set_exception(TimeoutError(
+                'No response from service {} for request {}'.format(
+                    self.srv_name, sequence_number)))
+
+    def _bind_executor(self, future, executor=None):
+        # Done callbacks of the future are only scheduled if it knows an executor
+        if executor is None and self._node_weakref is not None:
+            node = self._node_weakref()
+            if node is not None:
+                executor = node.executor
+        if executor is not None:
+            future._set_executor(executor)
+
+    def _set_response(self, sequence_number, response, executor=None):
+        """
+        Complete the pending request a response was taken for.
+
+        :param executor: the executor which took the response, else the one of the node is used
+            to schedule the done callbacks of the future.
+        """
+        future = self._pending_requests.pop(sequence_number, None)
+        if future is None:
+            with self._lock:
+                future = self._pending_requests.pop(sequence_number, None)
+                if future is None:
+                    if self._sends_in_progress:
+                        # The request may not be registered yet
+                        self._early_responses[sequence_number] = response
+                    # Else the request was cancelled or timed out
+                    return
+        self._sequence_numbers.pop(future, None)
+        self._bind_executor(future, executor)
+        future.set_result(response)
+        waiter = self._sync_waiters.get(sequence_number)
+        if isinstance(waiter, threading.Event):
+            waiter.set()
+        elif waiter is not None:
+            # Wake the thread waiting in call(), which may be waiting on the client
+            _rclpy.rclpy_trigger_guard_condition(waiter)
+
+    def _take_expiry_timer(self):
+        # Detach the expiry timer so the node can destroy it with the client
+        with self._lock:
+            timer = self._expiry_timer
+            self._expiry_timer = None
+            self._expiry_scheduled_at = None
+        return timer
+
+    def _destroy_sync_waiters(self):
+        while self._sync_waiter_pool:
+            wait_set, guard = self._sync_waiter_pool.pop()
+            _rclpy.rclpy_destroy_wait_set(wait_set)
+            _rclpy.rclpy_destroy_entity(guard)
+
     def service_is_ready(self):
         return _rclpy.rclpy_service_server_is_available(self.node_handle, self.client_handle)
 
     def wait_for_service(self, timeout_sec=None):
-        # TODO(sloretz) Return as soon as the service is available
-        # This is a temporary implementation. The sleep time is arbitrary.
-        sleep_time = 0.25
-        if timeout_sec is None:
+        """
+        Wait for a service server to become ready.
+
+        Sleeps on the graph guard condition of the node, so it returns as soon as the server is
+        discovered rather than polling. Threads waiting for services of the same node share one
+        wait on the guard condition.
+
+        :param timeout_sec: Seconds to wait. Block forever if None or negative. Don't wait if 0
+        :type timeout_sec: float or None
+        :return: ``True`` if the service server is ready.
+        :rtype: bool
+        """
+        if self.service_is_ready():
+            return True
+        if timeout_sec is None or timeout_sec < 0:
             timeout_sec = float('inf')
-        while self.context.ok() and not self.service_is_ready() and timeout_sec > 0.0:
-            time.sleep(sleep_time)
-            timeout_sec -= sleep_time
+        deadline = time.monotonic() + timeout_sec
+
+        waiter = _GraphWaiter.acquire(self.node_handle)
+        try:
+            waiter.wait_until(self.service_is_ready, self.context, deadline)
+        finally:
+            _GraphWaiter.release(self.node_handle)
 
         return self.service_is_ready()
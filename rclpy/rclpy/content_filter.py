@@ -0,0 +1,71 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import ast
+from collections import namedtuple
+import re
+
+from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
+
+_FILTER_PATTERN = re.compile(
+    r'^\s*(?P<field>[A-Za-z_]\w*(?:\s*\.\s*[A-Za-z_]\w*)*)\s*'
+    r'(?:%\s*(?P<modulus>\d+)\s*)?'
+    r'(?P<op>==|!=|<=|>=|<|>)\s*'
+    r'(?P<operand>.+?)\s*$')
+
+
+class ContentFilter(
+        namedtuple('ContentFilter', ['field_names', 'op', 'operand', 'modulus'])):
+    """
+    A predicate on a single message field.
+
+    Expressions have the form ``<field> <op> <literal>`` or ``<field> % <N> <op> <literal>``,
+    e.g. ``header.frame_id == 'base'`` or ``id % 4 == 1``.
+    ``<op>`` is one of ``==``, ``!=``, ``<``, ``<=``, ``>``, ``>=`` and ``<literal>`` is a
+    Python bool, int, float or str literal.
+    """
+
+    @classmethod
+    def parse(cls, expression):
+        """
+        Parse a content filter expression.
+
+        :param expression: the filter expression.
+        :type expression: str
+        :raises: ValueError if the expression is malformed.
+        :rtype: :class:`ContentFilter`
+        """
+        match = _FILTER_PATTERN.match(expression)
+        if match is None:
+            raise ValueError("Invalid content filter expression '{}'".format(expression))
+        try:
+            operand = ast.literal_eval(match.group('operand'))
+        except (ValueError, SyntaxError) as e:
+            raise ValueError(
+                "Invalid literal in content filter expression '{}'".format(expression)) from e
+        if not isinstance(operand, (bool, int, float, str)):
+            raise ValueError(
+                "Content filter literal must be a bool, int, float or str: '{}'".format(
+                    expression))
+        modulus = match.group('modulus')
+        modulus = 0 if modulus is None else int(modulus)
+        if match.group('modulus') is not None and modulus == 0:
+            raise ValueError("Content filter modulus must not be zero: '{}'".format(expression))
+        field_names = tuple(name.strip() for name in match.group('field').split('.'))
+        return cls(field_names, match.group('op'), operand, modulus)
+
+    def create_handle(self, msg_type):
+        """Resolve the filter against a message type and return a handle for rclpy_take."""
+        return _rclpy.rclpy_create_content_filter(
+            msg_type, self.field_names, self.op, self.operand, self.modulus)
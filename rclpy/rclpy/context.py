@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import os
 import threading
 
 
@@ -28,6 +29,9 @@ class Context:
         from rclpy.impl.implementation_singleton import rclpy_implementation
         self._handle = rclpy_implementation.rclpy_create_context()
         self._lock = threading.Lock()
+        # Parsed parameters files by path, with the modification time they were parsed at
+        self._param_files = {}
+        self._param_files_lock = threading.Lock()
 
     @property
     def handle(self):
@@ -52,3 +56,31 @@ class Context:
         with self._lock:
             if rclpy_implementation.rclpy_ok(self._handle):
                 return rclpy_implementation.rclpy_shutdown(self._handle)
+
+    def _parse_param_file(self, path):
+        """
+        Get the parameters in a YAML parameters file, parsing it only if it changed.
+
+        The result is shared by every node of this context that reads the file and must not be
+        modified.
+
+        :param path: Path of the parameters file.
+        :returns: Dictionary of fully qualified node names to dictionaries of parameter names to
+            :class:`rclpy.parameter.Parameter`.
+        :raises RuntimeError: if the file cannot be parsed.
+        """
+        # imported locally to avoid loading extensions on module import
+        from rclpy.impl.implementation_singleton import rclpy_implementation
+        from rclpy.parameter import Parameter
+        try:
+            mtime = os.stat(path).st_mtime_ns
+        except OSError:
+            # Let the parser report the error
+            return rclpy_implementation.rclpy_parse_param_file(Parameter, path)
+        with self._param_files_lock:
+            cached = self._param_files.get(path)
+            if cached is not None and cached[0] == mtime:
+                return cached[1]
+            params_by_node_name = rclpy_implementation.rclpy_parse_param_file(Parameter, path)
+            self._param_files[path] = (mtime, params_by_node_name)
+            return params_by_node_name
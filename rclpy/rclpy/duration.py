@@ -12,59 +12,36 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import functools
+
 import builtin_interfaces
 from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 
 
-class Duration:
+class Duration(_rclpy.Duration):
+    """
+    A span of time, which may be negative.
+
+    Storage and comparisons are implemented by the C base class.
+    """
+
+    __slots__ = ()
 
     def __init__(self, *, seconds=0, nanoseconds=0):
         total_nanoseconds = int(seconds * 1e9)
         total_nanoseconds += int(nanoseconds)
         try:
-            self._duration_handle = _rclpy.rclpy_create_duration(total_nanoseconds)
+            super().__init__(total_nanoseconds)
         except OverflowError as e:
             raise OverflowError(
                 'Total nanoseconds value is too large to store in C time point.') from e
 
-    @property
-    def nanoseconds(self):
-        return _rclpy.rclpy_duration_get_nanoseconds(self._duration_handle)
-
     def __repr__(self):
         return 'Duration(nanoseconds={0})'.format(self.nanoseconds)
 
-    def __eq__(self, other):
-        if isinstance(other, Duration):
-            return self.nanoseconds == other.nanoseconds
-        # Raise instead of returning NotImplemented to prevent comparison with invalid types,
-        # e.g. ints.
-        # Otherwise `Duration(nanoseconds=5) == 5` will return False instead of raising, and this
-        # could lead to hard-to-find bugs.
-        raise TypeError("Can't compare duration with object of type: ", type(other))
-
-    def __ne__(self, other):
-        return not self.__eq__(other)
-
-    def __lt__(self, other):
-        if isinstance(other, Duration):
-            return self.nanoseconds < other.nanoseconds
-        return NotImplemented
-
-    def __le__(self, other):
-        if isinstance(other, Duration):
-            return self.nanoseconds <= other.nanoseconds
-        return NotImplemented
-
-    def __gt__(self, other):
-        if isinstance(other, Duration):
-            return self.nanoseconds > other.nanoseconds
-        return NotImplemented
-
-    def __ge__(self, other):
-        if isinstance(other, Duration):
-            return self.nanoseconds >= other.nanoseconds
-        return NotImplemented
+    def __reduce__(self):
+        # The C base class can't be pickled or copied, rebuild the duration from its value
+        return (functools.partial(type(self), nanoseconds=self.nanoseconds), ())
 
     def to_msg(self):
         seconds = int(self.nanoseconds * 1e-9)
@@ -19,7 +19,10 @@ from threading import Condition
 from threading import Lock
 from threading import RLock
 
+import builtin_interfaces.msg
+from rclpy.constants import S_TO_NS
 from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
+from rclpy.subscription import MessageInfo
 from rclpy.task import Task
 from rclpy.timer import WallTimer
 from rclpy.utilities import get_default_context
@@ -208,6 +211,12 @@ class Executor:
                 # Rebuild the wait set so it doesn't include this node
                 _rclpy.rclpy_trigger_guard_condition(self._guard_condition)
 
+    def wake(self):
+        """Interrupt a wait in progress so the executor rebuilds its wait set."""
+        gc = self._guard_condition
+        if gc is not None:
+            _rclpy.rclpy_trigger_guard_condition(gc)
+
     def get_nodes(self):
         """
         Return nodes which have been added to this executor.
@@ -246,12 +255,18 @@ class Executor:
         await await_or_execute(tmr.callback)
 
     def _take_subscription(self, sub):
-        msg = _rclpy.rclpy_take(sub.subscription_handle, sub.msg_type)
+        msg = _rclpy.rclpy_take(
+            sub.subscription_handle, sub.msg_type, sub.content_filter_handle, sub.keep_latest,
+            sub.latency_tracker_handle, sub.message_info)
         return msg
 
     async def _execute_subscription(self, sub, msg):
         if msg:
-            await await_or_execute(sub.callback, msg)
+            if sub.message_info:
+                msg, info = msg
+                await await_or_execute(sub.callback, msg, MessageInfo(*info))
+            else:
+                await await_or_execute(sub.callback, msg)
 
     def _take_client(self, client):
         return _rclpy.rclpy_take_response(client.client_handle, client.srv_type.Response)
@@ -259,16 +274,11 @@ class Executor:
     async def _execute_client(self, client, seq_and_response):
         sequence, response = seq_and_response
         if sequence is not None:
-            try:
-                future = client._pending_requests[sequence]
-            except IndexError:
-                # The request was cancelled
-                pass
-            else:
-                future._set_executor(self)
-                future.set_result(response)
+            client._set_response(sequence, response, self)
 
     def _take_service(self, srv):
+        if srv.max_concurrency is not None:
+            return srv._take_requests()
         request_and_header = _rclpy.rclpy_take_request(
             srv.service_handle, srv.srv_type.Request)
         return request_and_header
@@ -276,6 +286,9 @@ class Executor:
     async def _execute_service(self, srv, request_and_header):
         if request_and_header is None:
             return
+        if srv.max_concurrency is not None:
+            srv._dispatch(request_and_header, self)
+            return
         (request, header) = request_and_header
         if request:
             response = await await_or_execute(srv.callback, request, srv.srv_type.Response())
@@ -383,7 +396,9 @@ class Executor:
                 subscriptions.extend(filter(self.can_execute, node.subscriptions))
                 timers.extend(filter(self.can_execute, node.timers))
                 clients.extend(filter(self.can_execute, node.clients))
-                services.extend(filter(self.can_execute, node.services))
+                services.extend(
+                    srv for srv in filter(self.can_execute, node.services)
+                    if srv._has_capacity())
                 node_guards = filter(self.can_execute, node.guards)
                 waitables.extend(filter(self.can_execute, node.waitables))
                 # retrigger a guard condition that was triggered but not handled
@@ -590,3 +605,78 @@ class MultiThreadedExecutor(Executor):
             pass
         else:
             self._executor.submit(handler)
+
+
+class LockstepExecutor(SingleThreadedExecutor):
+    """
+    Runs callbacks in step with a simulator that drives ROS time through ``/clock``.
+
+    Whenever no more work can run right away, including timers that are due at the current ROS
+    time, the executor publishes the current ROS time of the reporting node's clock on a
+    completion topic, once per distinct time.
+    A simulator can advance ``/clock`` as soon as every executor has reported the time it last
+    published, instead of running at a fixed real-time factor.
+    Nothing is reported while ROS time is not active on the clock.
+
+    Messages that are still in transit between nodes when the executor goes idle are not waited
+    for.
+    """
+
+    def __init__(self, node, *, completion_topic='~/step_complete', context=None):
+        """
+        Initialize the executor.
+
+        :param node: Node whose clock is reported and which publishes the reports. It is not
+            added to the executor.
+        :param completion_topic: Topic of the ``builtin_interfaces/Time`` reports.
+        """
+        super().__init__(context=context)
+        self._node = node
+        self._clock = node.get_clock()
+        self._completion_pub = node.create_publisher(
+            builtin_interfaces.msg.Time, completion_topic)
+        self._last_step_ns = None
+
+    def shutdown(self, timeout_sec=None):
+        if not super().shutdown(timeout_sec):
+            return False
+        if self._completion_pub is not None:
+            self._node.destroy_publisher(self._completion_pub)
+            self._completion_pub = None
+        return True
+
+    def spin_once(self, timeout_sec=None):
+        try:
+            handler, entity, node = self._poll()
+        except TimeoutException:
+            self._report_step_complete()
+            try:
+                handler, entity, node = self.wait_for_ready_callbacks(timeout_sec=timeout_sec)
+            except TimeoutException:
+                return
+        handler()
+        if handler.exception() is not None:
+            raise handler.exception()
+
+    def _poll(self):
+        """Get work that is ready right away, waiting on everything the executor handles."""
+        # A zero timeout wait started before the last callbacks ran only yields what was ready
+        # then, e.g. not a timer that a /clock message made due since.
+        resumed = self._cb_iter is not None and self._last_kwargs == {'timeout_sec': 0}
+        try:
+            return self.wait_for_ready_callbacks(timeout_sec=0)
+        except TimeoutException:
+            if not resumed:
+                raise
+        # The resumed wait is finished, so this starts a new one
+        return self.wait_for_ready_callbacks(timeout_sec=0)
+
+    def _report_step_complete(self):
+        if not self._clock.ros_time_is_active:
+            return
+        now = self._clock.now_ns()
+        if now == self._last_step_ns:
+            return
+        self._last_step_ns = now
+        sec, nanosec = divmod(now, S_TO_NS)
+        self._completion_pub.publish(builtin_interfaces.msg.Time(sec=sec, nanosec=nanosec))
@@ -15,22 +15,34 @@
 
 from collections import namedtuple
 from collections import OrderedDict
-import inspect
 import os
 import time
 
 from rclpy.impl.implementation_singleton import rclpy_logging_implementation as _rclpy_logging
 
-# Known filenames from which logging methods can be called (will be ignored in `_find_caller`).
+# Values of rclpy.logging.LoggingSeverity, which cannot be imported here because it imports this
+# module.
+_SEVERITY_DEBUG = 10
+_SEVERITY_INFO = 20
+_SEVERITY_WARN = 30
+_SEVERITY_ERROR = 40
+_SEVERITY_FATAL = 50
+
+# Known filenames from which logging methods can be called (will be ignored in `_get_caller`).
+# Filenames added after the first logging call only apply to code that has not logged yet.
 _internal_callers = []
 # This will cause rclpy filenames to be registered in `_internal_callers` on first logging call.
 _populate_internal_callers = True
 
 
-def _find_caller(frame):
-    """Get the first calling frame that is outside of rclpy."""
+def _get_caller():
+    """
+    Get the first caller that is outside of rclpy.
+
+    :returns: a tuple of a hashable call site, the function name, the file path and the line
+        number of the caller.
+    """
     global _populate_internal_callers
-    global _internal_callers
     if _populate_internal_callers:
         # Populate the list of internal filenames from which logging methods can be called.
         # This has to be done from within a function to avoid cyclic module imports.
@@ -41,13 +53,11 @@ def _find_caller(frame):
             os.path.realpath(__file__),
             os.path.realpath(rclpy.logging.__file__),
         ])
+        _rclpy_logging.rclpy_logging_set_internal_callers(_internal_callers)
         _populate_internal_callers = False
-
-    file_path = os.path.realpath(inspect.getframeinfo(frame).filename)
-    while any(f in file_path for f in _internal_callers):
-        frame = frame.f_back
-        file_path = os.path.realpath(inspect.getframeinfo(frame).filename)
-    return frame
+    # The extension walks the frames and caches the file paths per code object, which avoids
+    # reading source files and resolving paths on every call.
+    return _rclpy_logging.rclpy_logging_get_caller()
 
 
 class CallerId(
@@ -55,13 +65,18 @@ class CallerId(
 
     def __new__(cls, frame=None):
         if not frame:
-            frame = _find_caller(inspect.currentframe())
+            (_, last_index), function_name, file_path, line_number = _get_caller()
+        else:
+            function_name = frame.f_code.co_name
+            file_path = os.path.abspath(frame.f_code.co_filename)
+            line_number = frame.f_lineno
+            last_index = frame.f_lasti
         return super(CallerId, cls).__new__(
             cls,
-            function_name=frame.f_code.co_name,
-            file_path=os.path.abspath(inspect.getframeinfo(frame).filename),
-            line_number=frame.f_lineno,
-            last_index=frame.f_lasti,  # To distinguish between two callers on the same line
+            function_name=function_name,
+            file_path=file_path,
+            line_number=line_number,
+            last_index=last_index,  # To distinguish between two callers on the same line
         )
 
 
@@ -214,19 +229,44 @@ def get_filters_from_kwargs(**kwargs):
     return detected_filters
 
 
+# Loggers returned by `RcutilsLogger.get_child`, by full name. Interning them keeps the state of
+# the logging filters and the cached effective level across calls getting the same logger.
+_loggers = {}
+
+
 class RcutilsLogger:
 
     def __init__(self, name=''):
         self.name = name
         self.contexts = {}
+        # Effective level of the logger, valid while the logger level generation of the logging
+        # extension is the one it was read at.
+        self._effective_level = 0
+        self._level_generation = None
+        # Children of the logger by relative name, so getting them again does not build the name
+        self._children = {}
 
     def get_child(self, name):
+        """
+        Get the child logger of this logger with the given name.
+
+        The same logger instance is returned for a full name for the lifetime of the process.
+        """
+        child = self._children.get(name)
+        if child is not None:
+            return child
         if not name:
             raise ValueError('Child logger name must not be empty.')
+        full_name = name
         if self.name:
             # Prepend the name of this logger
-            name = self.name + '.' + name
-        return RcutilsLogger(name=name)
+            full_name = self.name + '.' + name
+        child = _loggers.get(full_name)
+        if child is None:
+            # setdefault keeps a single logger if another thread created it meanwhile
+            child = _loggers.setdefault(full_name, RcutilsLogger(name=full_name))
+        self._children[name] = child
+        return child
 
     def set_level(self, level):
         from rclpy.logging import LoggingSeverity
@@ -242,7 +282,16 @@ class RcutilsLogger:
     def is_enabled_for(self, severity):
         from rclpy.logging import LoggingSeverity
         severity = LoggingSeverity(severity)
-        return _rclpy_logging.rclpy_logging_logger_is_enabled_for(self.name, severity)
+        if self._level_generation != _rclpy_logging.logger_level_generation:
+            self._update_effective_level()
+        return severity >= self._effective_level
+
+    def _update_effective_level(self):
+        # Read the generation first so a level set meanwhile invalidates the level read below
+        generation = _rclpy_logging.logger_level_generation
+        self._effective_level = \
+            _rclpy_logging.rclpy_logging_get_logger_effective_level(self.name)
+        self._level_generation = generation
 
     def log(self, message, severity, **kwargs):
         r"""
@@ -255,12 +304,13 @@ class RcutilsLogger:
 
         .. note::
            Logging filters will only be evaluated if the logger is enabled for the message's
-           severity.
+           severity. Calls for severities the logger is not enabled for return before the
+           arguments are checked.
 
         :param message str: message to log.
         :param severity: severity of the message.
         :type severity: :py:class:LoggingSeverity
-        :keyword name str: name of the logger to use.
+        :keyword name str: name of the logger to use, which may differ between calls.
         :param \**kwargs: optional parameters for logging filters (see below).
 
         :Keyword Arguments:
@@ -278,76 +328,85 @@ class RcutilsLogger:
         :raises: ValueError on invalid parameters values.
         :rtype: bool
         """
+        # Calls for disabled severities must be cheap: check the cached level before anything.
+        if self._level_generation != _rclpy_logging.logger_level_generation:
+            self._update_effective_level()
+        if severity < self._effective_level:
+            return False
+
+        # Get/prepare the context corresponding to the caller.
+        call_site, function_name, file_path, line_number = _get_caller()
+        context = self.contexts.get(call_site)
+        # Calls from a call site normally repeat the arguments of its last checked call.
+        if context is None or kwargs != context['kwargs'] or severity != context['severity']:
+            context = self._get_checked_context(call_site, severity, kwargs)
+
+        # Check if any filter determines the message shouldn't be processed.
+        # Note(dhood): even if a message doesn't get logged, a filter might still update its state
+        # as if it had been. This matches the behavior of the C logging macros provided by rcutils.
+        for logging_filter in context['filters']:
+            if not supported_filters[logging_filter].should_log(context):
+                return False
+
+        # Call the relevant function from the C extension.
+        _rclpy_logging.rclpy_logging_rcutils_log(
+            severity, kwargs.get('name', self.name), message, function_name, file_path,
+            line_number)
+        return True
+
+    def _get_checked_context(self, call_site, severity, kwargs):
         from rclpy.logging import LoggingSeverity
         severity = LoggingSeverity(severity)
 
-        name = kwargs.pop('name', self.name)
+        # The name is not part of the state of the filters
+        filter_kwargs = dict(kwargs)
+        filter_kwargs.pop('name', None)
 
         # Infer the requested log filters from the keyword arguments
-        detected_filters = get_filters_from_kwargs(**kwargs)
+        detected_filters = get_filters_from_kwargs(**filter_kwargs)
 
-        # Get/prepare the context corresponding to the caller.
-        caller_id = CallerId()
-        if caller_id not in self.contexts:
-            context = {'name': name, 'severity': severity}
+        if call_site not in self.contexts:
+            context = {'severity': severity, 'kwargs': dict(kwargs)}
             for detected_filter in detected_filters:
                 if detected_filter in supported_filters:
-                    supported_filters[detected_filter].initialize_context(context, **kwargs)
+                    supported_filters[detected_filter].initialize_context(
+                        context, **filter_kwargs)
             context['filters'] = detected_filters
-            self.contexts[caller_id] = context
+            self.contexts[call_site] = context
         else:
-            context = self.contexts[caller_id]
+            context = self.contexts[call_site]
             # Don't support any changes to the logger.
             if severity != context['severity']:
                 raise ValueError('Logger severity cannot be changed between calls.')
-            if name != context['name']:
-                raise ValueError('Logger name cannot be changed between calls.')
             if detected_filters != context['filters']:
                 raise ValueError('Requested logging filters cannot be changed between calls.')
             for detected_filter in detected_filters:
                 filter_params = supported_filters[detected_filter].params
-                if any(context[p] != kwargs.get(p, filter_params[p]) for p in filter_params):
+                if any(
+                    context[p] != filter_kwargs.get(p, filter_params[p]) for p in filter_params
+                ):
                     raise ValueError(
                         'Logging filter parameters cannot be changed between calls.')
-
-        # Only check filters if the severity is appropriate.
-        if not self.is_enabled_for(severity):
-            return False
-
-        # Check if any filter determines the message shouldn't be processed.
-        # Note(dhood): even if a message doesn't get logged, a filter might still update its state
-        # as if it had been. This matches the behavior of the C logging macros provided by rcutils.
-        for logging_filter in context['filters']:
-            if not supported_filters[logging_filter].should_log(context):
-                return False
-
-        # Call the relevant function from the C extension.
-        _rclpy_logging.rclpy_logging_rcutils_log(
-            severity, name, message,
-            caller_id.function_name, caller_id.file_path, caller_id.line_number)
-        return True
+            # Equivalent arguments, such as another logger name, take the fast path from now on
+            context['kwargs'] = dict(kwargs)
+        return context
 
     def debug(self, message, **kwargs):
         """Log a message with `DEBUG` severity via :py:classmethod:RcutilsLogger.log:."""
-        from rclpy.logging import LoggingSeverity
-        return self.log(message, LoggingSeverity.DEBUG, **kwargs)
+        return self.log(message, _SEVERITY_DEBUG, **kwargs)
 
     def info(self, message, **kwargs):
         """Log a message with `INFO` severity via :py:classmethod:RcutilsLogger.log:."""
-        from rclpy.logging import LoggingSeverity
-        return self.log(message, LoggingSeverity.INFO, **kwargs)
+        return self.log(message, _SEVERITY_INFO, **kwargs)
 
     def warn(self, message, **kwargs):
         """Log a message with `WARN` severity via :py:classmethod:RcutilsLogger.log:."""
-        from rclpy.logging import LoggingSeverity
-        return self.log(message, LoggingSeverity.WARN, **kwargs)
+        return self.log(message, _SEVERITY_WARN, **kwargs)
 
     def error(self, message, **kwargs):
         """Log a message with `ERROR` severity via :py:classmethod:RcutilsLogger.log:."""
-        from rclpy.logging import LoggingSeverity
-        return self.log(message, LoggingSeverity.ERROR, **kwargs)
+        return self.log(message, _SEVERITY_ERROR, **kwargs)
 
     def fatal(self, message, **kwargs):
         """Log a message with `FATAL` severity via :py:classmethod:RcutilsLogger.log:."""
-        from rclpy.logging import LoggingSeverity
-        return self.log(message, LoggingSeverity.FATAL, **kwargs)
+        return self.log(message, _SEVERITY_FATAL, **kwargs)
@@ -13,6 +13,7 @@
 # limitations under the License.
 
 
+import atexit
 from enum import IntEnum
 
 from rclpy.impl.implementation_singleton import rclpy_logging_implementation as _rclpy_logging
@@ -36,6 +37,8 @@ class LoggingSeverity(IntEnum):
 
 _root_logger = rclpy.impl.rcutils_logger.RcutilsLogger()
 
+_async_exit_handler_registered = False
+
 
 def get_logger(name):
     if not name:
@@ -48,6 +51,7 @@ def initialize():
 
 
 def shutdown():
+    """Shutdown the logging system, after writing the messages queued by asynchronous logging."""
     return _rclpy_logging.rclpy_logging_shutdown()
 
 
@@ -65,3 +69,59 @@ def set_logger_level(name, level):
 def get_logger_effective_level(name):
     logger_level = _rclpy_logging.rclpy_logging_get_logger_effective_level(name)
     return LoggingSeverity(logger_level)
+
+
+def enable_async(capacity=1024):
+    """
+    Write log messages from a background thread.
+
+    Logging calls only queue the messages, so slow output does not delay them. The messages keep
+    the time they were logged at. Messages logged while ``capacity`` messages are waiting to be
+    written are dropped and counted, see :func:`get_async_stats`. The queued messages are written
+    by :func:`disable_async`, :func:`shutdown` or when the interpreter exits.
+
+    :param capacity: Maximum number of messages waiting to be written.
+    :raises RuntimeError: if asynchronous logging is already enabled.
+    """
+    global _async_exit_handler_registered
+    _rclpy_logging.rclpy_logging_enable_async(capacity)
+    if not _async_exit_handler_registered:
+        atexit.register(disable_async)
+        _async_exit_handler_registered = True
+
+
+def disable_async():
+    """Write the messages queued by asynchronous logging and stop the background thread."""
+    return _rclpy_logging.rclpy_logging_disable_async()
+
+
+def get_async_stats():
+    """
+    Get the counters of asynchronous logging.
+
+    :returns: dictionary with the number of messages ``queued`` and waiting to be written now,
+        and the numbers of messages ``written`` and ``dropped`` because too many were queued
+        since the process started.
+    """
+    return _rclpy_logging.rclpy_logging_get_async_stats()
+
+
+def enable_binary_output(path, size=16 * 1024 * 1024):
+    """
+    Write log messages as compact binary records to a file instead of the console.
+
+    The file is mapped in memory and has a fixed size: once it is full, the oldest records are
+    overwritten. Records survive a crash of the process without being flushed. The file can be
+    turned back into text with :mod:`rclpy.binary_log`.
+    Binary output is disabled by :func:`shutdown`, and so by :func:`clear_config`.
+
+    :param path: Path of the file, which is overwritten.
+    :param size: Size of the file in bytes, at least 64 KiB.
+    :raises RuntimeError: if binary output is already enabled.
+    """
+    _rclpy_logging.rclpy_logging_enable_binary_output(path, size)
+
+
+def disable_binary_output():
+    """Stop writing log messages to the binary log file and go back to the previous output."""
+    return _rclpy_logging.rclpy_logging_disable_binary_output()
@@ -12,6 +12,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import inspect
+import threading
 import weakref
 
 from rcl_interfaces.msg import ParameterEvent, SetParametersResult
@@ -19,6 +21,7 @@ from rclpy.callback_groups import MutuallyExclusiveCallbackGroup
 from rclpy.client import Client
 from rclpy.clock import ROSClock
 from rclpy.constants import S_TO_NS
+from rclpy.content_filter import ContentFilter
 from rclpy.exceptions import NotInitializedException
 from rclpy.exceptions import NoTypeSupportImportedException
 from rclpy.expand_topic_name import expand_topic_name
@@ -26,13 +29,18 @@ from rclpy.guard_condition import GuardCondition
 from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 from rclpy.logging import get_logger
 from rclpy.parameter import Parameter
+from rclpy.parameter_handle import ParameterHandle
+from rclpy.parameter_handle import to_parameter_type
+from rclpy.parameter_index import ParameterIndex
 from rclpy.parameter_service import ParameterService
 from rclpy.publisher import Publisher
+from rclpy.publisher import PublishQueueOverflowPolicy
 from rclpy.qos import qos_profile_default, qos_profile_parameter_events
 from rclpy.qos import qos_profile_services_default
 from rclpy.service import Service
 from rclpy.subscription import Subscription
 from rclpy.time_source import TimeSource
+from rclpy.timer import Timer
 from rclpy.timer import WallTimer
 from rclpy.utilities import get_default_context
 from rclpy.validate_full_topic_name import validate_full_topic_name
@@ -61,11 +69,13 @@ class Node:
 
     def __init__(
         self, node_name, *, context=None, cli_args=None, namespace=None, use_global_arguments=True,
-        start_parameter_services=True, initial_parameters=None
+        start_parameter_services=True, initial_parameters=None, parameter_event_window_sec=None
     ):
         self._handle = None
         self._context = get_default_context() if context is None else context
         self._parameters = {}
+        self._parameter_index = ParameterIndex()
+        self._parameter_handles = {}
         self.publishers = []
         self.subscriptions = []
         self.clients = []
@@ -75,6 +85,12 @@ class Node:
         self.waitables = []
         self._default_callback_group = MutuallyExclusiveCallbackGroup()
         self._parameters_callback = None
+        # Whether each parameter changed since the last parameter event was set before the change
+        self._pending_parameter_changes = {}
+        self._pending_parameter_changes_lock = threading.Lock()
+
+        if parameter_event_window_sec is not None and parameter_event_window_sec <= 0:
+            raise ValueError('parameter_event_window_sec must be greater than zero')
 
         namespace = namespace or ''
         if not self._context.ok():
@@ -105,8 +121,17 @@ class Node:
 
         self._parameter_event_publisher = self.create_publisher(
             ParameterEvent, 'parameter_events', qos_profile=qos_profile_parameter_events)
-
-        node_parameters = _rclpy.rclpy_get_node_parameters(Parameter, self.handle)
+        self._parameter_event_timer = None
+        if parameter_event_window_sec is not None:
+            self._parameter_event_timer = self.create_timer(
+                parameter_event_window_sec, self._publish_parameter_event)
+
+        node_parameters = {}
+        node_name_with_namespace = self.get_fully_qualified_name()
+        for param_file in _rclpy.rclpy_get_node_param_files(self.handle):
+            # Files are parsed once per context and shared by all the nodes created from them
+            params_by_node_name = self._context._parse_param_file(param_file)
+            node_parameters.update(params_by_node_name.get(node_name_with_namespace, {}))
         # Combine parameters from params files with those from the node constructor and
         # use the set_parameters_atomically API so a parameter event is published.
         if initial_parameters is not None:
@@ -151,6 +176,9 @@ class Node:
     def get_namespace(self):
         return _rclpy.rclpy_get_node_namespace(self.handle)
 
+    def get_fully_qualified_name(self):
+        return self.get_namespace().rstrip('/') + '/' + self.get_name()
+
     def get_clock(self):
         return self._clock
 
@@ -167,46 +195,129 @@ class Node:
             return Parameter(name, Parameter.Type.NOT_SET, None)
         return self._parameters[name]
 
+    def parameter_handle(self, name, type_=None):
+        """
+        Get a handle to read a parameter without looking it up.
+
+        The handle follows every change of the parameter made through :meth:`set_parameters`
+        and :meth:`set_parameters_atomically`. If ``type_`` is given, setting the parameter to a
+        value of another type fails for as long as the node exists.
+
+        :param name: Name of the parameter. It does not need to be set yet.
+        :param type_: ``bool``, ``int``, ``float``, ``str``, a
+            :class:`rclpy.parameter.Parameter.Type`, or ``None`` to allow any type.
+        :return: The handle of the parameter, shared by all the callers for that name.
+        :rtype: :class:`rclpy.parameter_handle.ParameterHandle`
+        :raises TypeError: if the parameter is set with a value of another type, or a handle
+            with another type exists.
+        """
+        type_ = to_parameter_type(type_)
+        with self._pending_parameter_changes_lock:
+            handle = self._parameter_handles.get(name)
+            if handle is None:
+                parameter = self.get_parameter(name)
+                handle = ParameterHandle(name, type_, parameter)
+                if not handle.accepts(parameter):
+                    raise TypeError("Parameter '{}' has type {}, not {}".format(
+                        name, parameter.type_, type_))
+                self._parameter_handles[name] = handle
+            elif type_ is not None and type_ != handle.type_:
+                if handle.type_ is not None:
+                    raise TypeError("Parameter '{}' already has a handle of type {}".format(
+                        name, handle.type_))
+                if not handle.accepts(self.get_parameter(name)):
+                    raise TypeError("Parameter '{}' has type {}, not {}".format(
+                        name, self.get_parameter(name).type_, type_))
+                handle.type_ = type_
+            return handle
+
     def set_parameters(self, parameter_list):
-        results = []
+        """
+        Set parameters one at a time.
+
+        Each parameter is accepted or rejected on its own by the parameters callback. The changes
+        of all the accepted parameters are published as a single parameter event.
+
+        :param parameter_list: List of :class:`rclpy.parameter.Parameter` to set.
+        :returns: List of ``SetParametersResult``, one per parameter.
+        """
         for param in parameter_list:
             if not isinstance(param, Parameter):
                 raise TypeError("parameter must be instance of type '{}'".format(repr(Parameter)))
-            results.append(self.set_parameters_atomically([param]))
+        results = [self._set_parameters_atomically([param]) for param in parameter_list]
+        self._flush_parameter_event()
         return results
 
     def set_parameters_atomically(self, parameter_list):
+        result = self._set_parameters_atomically(parameter_list)
+        self._flush_parameter_event()
+        return result
+
+    def _set_parameters_atomically(self, parameter_list):
         result = None
+        for param in parameter_list:
+            handle = self._parameter_handles.get(param.name)
+            if handle is not None and not handle.accepts(param):
+                return SetParametersResult(
+                    successful=False,
+                    reason="Parameter '{}' must have type {}".format(param.name, handle.type_))
         if self._parameters_callback:
             result = self._parameters_callback(parameter_list)
         else:
             result = SetParametersResult(successful=True)
 
         if result.successful:
-            parameter_event = ParameterEvent()
-            for param in parameter_list:
-                if Parameter.Type.NOT_SET == param.type_:
-                    if Parameter.Type.NOT_SET != self.get_parameter(param.name).type_:
+            with self._pending_parameter_changes_lock:
+                for param in parameter_list:
+                    self._pending_parameter_changes.setdefault(
+                        param.name, param.name in self._parameters)
+                    if Parameter.Type.NOT_SET == param.type_:
+                        # Delete any unset parameters regardless of their previous value.
+                        # We don't currently store NOT_SET parameters so this is an extra
+                        # precaution.
+                        if param.name in self._parameters:
+                            del self._parameters[param.name]
+                            self._parameter_index.remove(param.name)
+                    else:
+                        if param.name not in self._parameters:
+                            self._parameter_index.add(param.name)
+                        self._parameters[param.name] = param
+                    handle = self._parameter_handles.get(param.name)
+                    if handle is not None:
+                        handle._update(param)
+
+        return result
+
+    def _flush_parameter_event(self):
+        # With a window, the timer publishes the changes instead
+        if self._parameter_event_timer is None:
+            self._publish_parameter_event()
+
+    def _publish_parameter_event(self):
+        with self._pending_parameter_changes_lock:
+            if not self._pending_parameter_changes:
+                return
+            parameter_event = ParameterEvent(node=self.get_fully_qualified_name())
+            for name, was_set in self._pending_parameter_changes.items():
+                param = self._parameters.get(name)
+                if param is None:
+                    if was_set:
                         # Parameter deleted. (Parameter had value and new value is not set)
                         parameter_event.deleted_parameters.append(
-                            param.to_parameter_msg())
-                    # Delete any unset parameters regardless of their previous value.
-                    # We don't currently store NOT_SET parameters so this is an extra precaution.
-                    if param.name in self._parameters:
-                        del self._parameters[param.name]
+                            Parameter(name, Parameter.Type.NOT_SET, None).to_parameter_msg())
+                elif was_set:
+                    # Parameter changed. (Parameter had a value and new value is set)
+                    parameter_event.changed_parameters.append(param.to_parameter_msg())
                 else:
-                    if Parameter.Type.NOT_SET == self.get_parameter(param.name).type_:
-                        #  Parameter is new. (Parameter had no value and new value is set)
-                        parameter_event.new_parameters.append(param.to_parameter_msg())
-                    else:
-                        # Parameter changed. (Parameter had a value and new value is set)
-                        parameter_event.changed_parameters.append(
-                            param.to_parameter_msg())
-                    self._parameters[param.name] = param
+                    # Parameter is new. (Parameter had no value and new value is set)
+                    parameter_event.new_parameters.append(param.to_parameter_msg())
+            self._pending_parameter_changes.clear()
+        if (
+            parameter_event.new_parameters or parameter_event.changed_parameters or
+            parameter_event.deleted_parameters
+        ):
             self._parameter_event_publisher.publish(parameter_event)
 
-        return result
-
     def set_parameters_callback(self, callback):
         self._parameters_callback = callback
 
@@ -227,7 +338,24 @@ class Node:
         """Remove a class which itself is capable of add things to the wait set."""
         self.waitables.remove(waitable)
 
-    def create_publisher(self, msg_type, topic, *, qos_profile=qos_profile_default):
+    def create_publisher(
+            self, msg_type, topic, *, qos_profile=qos_profile_default, async_publish=False,
+            publish_queue_size=10, overflow_policy=PublishQueueOverflowPolicy.BLOCK):
+        """
+        Create a new publisher.
+
+        :param msg_type: The type of ROS messages the publisher will publish.
+        :param topic: The name of the topic the publisher will publish to.
+        :param qos_profile: The quality of service profile to apply to the publisher.
+        :param async_publish: If ``True``, :meth:`Publisher.publish` only queues the message and
+            a background thread converts and publishes it, so callers don't wait on the
+            conversion or the middleware.
+        :type async_publish: bool
+        :param publish_queue_size: Maximum number of messages waiting to be published when
+            ``async_publish`` is ``True``.
+        :param overflow_policy: What to do when the queue is full.
+        :type overflow_policy: :class:`rclpy.publisher.PublishQueueOverflowPolicy`
+        """
         # this line imports the typesupport for the message module if not already done
         check_for_type_support(msg_type)
         failed = False
@@ -238,17 +366,64 @@ class Node:
             failed = True
         if failed:
             self._validate_topic_or_service_name(topic)
-        publisher = Publisher(publisher_handle, msg_type, topic, qos_profile, self.handle)
+        publish_queue_handle = None
+        if async_publish:
+            try:
+                publish_queue_handle = _rclpy.rclpy_create_publish_queue(
+                    publisher_handle, publish_queue_size, overflow_policy)
+            except Exception:
+                _rclpy.rclpy_destroy_node_entity(publisher_handle, self.handle)
+                raise
+        publisher = Publisher(
+            publisher_handle, msg_type, topic, qos_profile, self.handle,
+            publish_queue_handle=publish_queue_handle)
         self.publishers.append(publisher)
         return publisher
 
     def create_subscription(
             self, msg_type, topic, callback, *, qos_profile=qos_profile_default,
-            callback_group=None):
+            callback_group=None, content_filter=None, keep_latest=False, message_info=False,
+            track_latency=False):
+        """
+        Create a new subscription.
+
+        :param msg_type: The type of ROS messages the subscription will subscribe to.
+        :param topic: The name of the topic the subscription will subscribe to.
+        :param callback: A user-defined callback function that is called when a message is
+            received by the subscription.
+        :param qos_profile: The quality of service profile to apply to the subscription.
+        :param callback_group: The callback group for the subscription. If ``None``, then the
+            node's default callback group is used.
+        :param content_filter: An expression like ``header.frame_id == 'base'`` or
+            ``id % 4 == 1``. Messages not matching it are dropped before they are converted to
+            Python and the callback is not called. See :class:`rclpy.content_filter.ContentFilter`.
+        :type content_filter: str or None
+        :param keep_latest: If ``True``, each time the subscription is ready all pending messages
+            are taken, only the newest one is converted to Python and the callback is called once
+            with it. Useful for slow consumers that only care about the latest state.
+        :type keep_latest: bool
+        :param message_info: If ``True``, the callback is called with a
+            :class:`rclpy.subscription.MessageInfo` as second argument.
+        :type message_info: bool
+        :param track_latency: Record a histogram of the time between the stamp of each message
+            and the moment it is taken, see
+            :meth:`rclpy.subscription.Subscription.get_latency_stats`.
+            ``True`` uses the ``header.stamp`` field, a string like ``'stamp'`` names another
+            ``builtin_interfaces/Time`` field. Stamps are compared to the system clock.
+        :type track_latency: bool or str
+        """
         if callback_group is None:
             callback_group = self._default_callback_group
         # this line imports the typesupport for the message module if not already done
         check_for_type_support(msg_type)
+        content_filter_handle = None
+        if content_filter is not None:
+            content_filter_handle = ContentFilter.parse(content_filter).create_handle(msg_type)
+        latency_tracker_handle = None
+        if track_latency:
+            stamp_field = 'header.stamp' if track_latency is True else track_latency
+            latency_tracker_handle = _rclpy.rclpy_create_latency_tracker(
+                msg_type, stamp_field.split('.'))
         failed = False
         try:
             [subscription_handle, subscription_pointer] = _rclpy.rclpy_create_subscription(
@@ -260,14 +435,30 @@ class Node:
 
         subscription = Subscription(
             subscription_handle, subscription_pointer, msg_type,
-            topic, callback, callback_group, qos_profile, self.handle)
+            topic, callback, callback_group, qos_profile, self.handle,
+            content_filter=content_filter, content_filter_handle=content_filter_handle,
+            keep_latest=keep_latest, message_info=message_info,
+            latency_tracker_handle=latency_tracker_handle)
         self.subscriptions.append(subscription)
         callback_group.add_entity(subscription)
         return subscription
 
     def create_client(
             self, srv_type, srv_name, *, qos_profile=qos_profile_services_default,
-            callback_group=None):
+            callback_group=None, request_timeout_sec=None):
+        """
+        Create a new service client.
+
+        :param srv_type: The service type.
+        :param srv_name: The name of the service.
+        :param qos_profile: The quality of service profile to apply to the client.
+        :param callback_group: The callback group for the client. If ``None``, then the node's
+            default callback group is used.
+        :param request_timeout_sec: Default timeout of :meth:`rclpy.client.Client.call_async`.
+            Requests without a response after that long fail with :class:`TimeoutError` and are
+            forgotten. ``None`` waits forever.
+        :type request_timeout_sec: float or None
+        """
         if callback_group is None:
             callback_group = self._default_callback_group
         check_for_type_support(srv_type)
@@ -285,14 +476,35 @@ class Node:
         client = Client(
             self.handle, self.context,
             client_handle, client_pointer, srv_type, srv_name, qos_profile,
-            callback_group)
+            callback_group, node=self, request_timeout_sec=request_timeout_sec)
         self.clients.append(client)
         callback_group.add_entity(client)
         return client
 
     def create_service(
             self, srv_type, srv_name, callback, *, qos_profile=qos_profile_services_default,
-            callback_group=None):
+            callback_group=None, max_concurrency=None):
+        """
+        Create a new service server.
+
+        :param srv_type: The service type.
+        :param srv_name: The name of the service.
+        :param callback: A user-defined callback function that is called when a service request
+            is received by the server. It takes the request and a response to fill in.
+        :param qos_profile: The quality of service profile to apply to the service server.
+        :param callback_group: The callback group for the service server. If ``None``, then the
+            node's default callback group is used.
+        :param max_concurrency: If not ``None``, the executor takes all queued requests at once
+            and ``callback`` runs on a pool of this many threads, outside the callback group.
+            Each response is sent as soon as its handler returns, so responses may go out in a
+            different order than the requests came in. ``callback`` must not be a coroutine.
+        :type max_concurrency: int or None
+        """
+        if max_concurrency is not None:
+            if max_concurrency < 1:
+                raise ValueError('max_concurrency must be at least 1')
+            if inspect.iscoroutinefunction(callback):
+                raise TypeError('Coroutine callbacks cannot run on the service worker pool')
         if callback_group is None:
             callback_group = self._default_callback_group
         check_for_type_support(srv_type)
@@ -309,16 +521,33 @@ class Node:
             self._validate_topic_or_service_name(srv_name, is_service=True)
         service = Service(
             self.handle, service_handle, service_pointer,
-            srv_type, srv_name, callback, callback_group, qos_profile)
+            srv_type, srv_name, callback, callback_group, qos_profile,
+            max_concurrency=max_concurrency)
         self.services.append(service)
         callback_group.add_entity(service)
         return service
 
-    def create_timer(self, timer_period_sec, callback, callback_group=None):
+    def create_timer(self, timer_period_sec, callback, callback_group=None, *, clock=None):
+        """
+        Create a new timer.
+
+        :param timer_period_sec: The period of the timer in seconds.
+        :param callback: A user-defined callback function that is called when the timer expires.
+        :param callback_group: The callback group for the timer. If ``None``, then the node's
+            default callback group is used.
+        :param clock: The clock the timer runs on. If ``None``, the timer uses a steady wall
+            clock. Pass :meth:`get_clock` to follow simulated time from ``/clock`` while ROS
+            time is active on the node's time source.
+        :type clock: :class:`rclpy.clock.Clock` or None
+        """
         timer_period_nsec = int(float(timer_period_sec) * S_TO_NS)
         if callback_group is None:
             callback_group = self._default_callback_group
-        timer = WallTimer(callback, callback_group, timer_period_nsec, context=self.context)
+        if clock is None:
+            timer = WallTimer(callback, callback_group, timer_period_nsec, context=self.context)
+        else:
+            timer = Timer(
+                callback, callback_group, timer_period_nsec, clock, context=self.context)
 
         self.timers.append(timer)
         callback_group.add_entity(timer)
@@ -336,6 +565,7 @@ class Node:
     def destroy_publisher(self, publisher):
         for pub in self.publishers:
             if pub.publisher_handle == publisher.publisher_handle:
+                pub._stop_publish_queue()
                 _rclpy.rclpy_destroy_node_entity(pub.publisher_handle, self.handle)
                 self.publishers.remove(pub)
                 return True
@@ -352,6 +582,10 @@ class Node:
     def destroy_client(self, client):
         for cli in self.clients:
             if cli.client_handle == client.client_handle:
+                expiry_timer = cli._take_expiry_timer()
+                if expiry_timer is not None:
+                    self.destroy_timer(expiry_timer)
+                cli._destroy_sync_waiters()
                 _rclpy.rclpy_destroy_node_entity(cli.client_handle, self.handle)
                 self.clients.remove(cli)
                 return True
@@ -360,6 +594,7 @@ class Node:
     def destroy_service(self, service):
         for srv in self.services:
             if srv.service_handle == service.service_handle:
+                srv._stop_workers()
                 _rclpy.rclpy_destroy_node_entity(srv.service_handle, self.handle)
                 self.services.remove(srv)
                 return True
@@ -369,8 +604,8 @@ class Node:
         for tmr in self.timers:
             if tmr.timer_handle == timer.timer_handle:
                 _rclpy.rclpy_destroy_entity(tmr.timer_handle)
-                # TODO(sloretz) Store clocks on node and destroy them separately
-                _rclpy.rclpy_destroy_entity(tmr.clock._clock_handle)
+                if tmr._owns_clock:
+                    _rclpy.rclpy_destroy_entity(tmr.clock._clock_handle)
                 self.timers.remove(tmr)
                 return True
         return False
@@ -388,27 +623,34 @@ class Node:
         if self.handle is None:
             return ret
 
+        # Publish the changes still waiting for the parameter event window to end.
+        self._publish_parameter_event()
+        self._parameter_event_timer = None
+
         # Drop extra reference to parameter event publisher.
         # It will be destroyed with other publishers below.
         self._parameter_event_publisher = None
 
         while self.publishers:
             pub = self.publishers.pop()
+            pub._stop_publish_queue()
             _rclpy.rclpy_destroy_node_entity(pub.publisher_handle, self.handle)
         while self.subscriptions:
             sub = self.subscriptions.pop()
             _rclpy.rclpy_destroy_node_entity(sub.subscription_handle, self.handle)
         while self.clients:
             cli = self.clients.pop()
+            cli._destroy_sync_waiters()
             _rclpy.rclpy_destroy_node_entity(cli.client_handle, self.handle)
         while self.services:
             srv = self.services.pop()
+            srv._stop_workers()
             _rclpy.rclpy_destroy_node_entity(srv.service_handle, self.handle)
         while self.timers:
             tmr = self.timers.pop()
             _rclpy.rclpy_destroy_entity(tmr.timer_handle)
-            # TODO(sloretz) Store clocks on node and destroy them separately
-            _rclpy.rclpy_destroy_entity(tmr.clock._clock_handle)
+            if tmr._owns_clock:
+                _rclpy.rclpy_destroy_entity(tmr.clock._clock_handle)
         while self.guards:
             gc = self.guards.pop()
             _rclpy.rclpy_destroy_entity(gc.guard_handle)
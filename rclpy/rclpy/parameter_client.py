@@ -0,0 +1,189 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import threading
+
+from rcl_interfaces.msg import ParameterEvent
+from rcl_interfaces.msg import Parameter as ParameterMsg
+from rcl_interfaces.srv import GetParameters, ListParameters
+from rclpy.parameter import Parameter
+from rclpy.qos import qos_profile_parameter_events, qos_profile_parameters
+from rclpy.task import Future
+from rclpy.validate_topic_name import TOPIC_SEPARATOR_STRING
+
+
+class CachedParameterClient:
+    """
+    Local mirror of the parameters of a remote node.
+
+    The parameters are fetched once with the ``list_parameters`` and ``get_parameters`` services
+    of the remote node, and then kept up to date from the parameter events it publishes on
+    ``parameter_events`` in its namespace. Reads are answered from the mirror without a service
+    call. The node the client is created with must be spinning for the mirror to be updated.
+    """
+
+    def __init__(self, node, remote_node_name, *, callback_group=None):
+        """
+        Create a CachedParameterClient.
+
+        :param node: The node used to call the services and subscribe to the events.
+        :param remote_node_name: Fully qualified name of the remote node, e.g. ``/ns/talker``.
+        :param callback_group: The callback group for the clients and the subscription. If
+            ``None``, then the node's default callback group is used.
+        """
+        if not remote_node_name.startswith(TOPIC_SEPARATOR_STRING):
+            remote_node_name = TOPIC_SEPARATOR_STRING + remote_node_name
+        self._node = node
+        self._remote_node_name = remote_node_name
+        self._lock = threading.Lock()
+        self._parameters = {}
+        self._ready = False
+        # Events received while fetching, replayed over the fetched parameters
+        self._pending_events = []
+        self._fetching = False
+
+        self._list_client = node.create_client(
+            ListParameters,
+            TOPIC_SEPARATOR_STRING.join((remote_node_name, 'list_parameters')),
+            qos_profile=qos_profile_parameters, callback_group=callback_group)
+        self._get_client = node.create_client(
+            GetParameters,
+            TOPIC_SEPARATOR_STRING.join((remote_node_name, 'get_parameters')),
+            qos_profile=qos_profile_parameters, callback_group=callback_group)
+        remote_namespace = remote_node_name.rsplit(TOPIC_SEPARATOR_STRING, 1)[0]
+        self._subscription = node.create_subscription(
+            ParameterEvent,
+            TOPIC_SEPARATOR_STRING.join((remote_namespace, 'parameter_events')),
+            self._on_parameter_event, qos_profile=qos_profile_parameter_events,
+            callback_group=callback_group)
+
+    @property
+    def remote_node_name(self):
+        return self._remote_node_name
+
+    def wait_for_services(self, timeout_sec=None):
+        """
+        Wait for the parameter services of the remote node to be available.
+
+        :param timeout_sec: Seconds to wait. Block forever if None or negative.
+        :return: True if the services are available.
+        """
+        return (
+            self._list_client.wait_for_service(timeout_sec) and
+            self._get_client.wait_for_service(timeout_sec))
+
+    def refresh(self):
+        """
+        Fetch all the parameters of the remote node into the mirror.
+
+        :return: a Future instance that completes with ``True`` when the mirror is loaded, or
+            with the exception raised by a service call
+        :rtype: :class:`rclpy.task.Future` instance
+        """
+        future = Future()
+        with self._lock:
+            self._fetching = True
+            self._pending_events = []
+        request = ListParameters.Request()
+        request.depth = ListParameters.Request.DEPTH_RECURSIVE
+        list_future = self._list_client.call_async(request)
+        list_future.add_done_callback(lambda f: self._on_list_response(f, future))
+        return future
+
+    def is_ready(self):
+        """Return True once the mirror has been loaded by :meth:`refresh`."""
+        with self._lock:
+            return self._ready
+
+    def get_parameter(self, name):
+        """
+        Get a parameter of the remote node from the mirror.
+
+        :param name: Name of the parameter.
+        :return: The parameter, with type ``NOT_SET`` if the remote node does not have it.
+        :rtype: :class:`rclpy.parameter.Parameter`
+        """
+        with self._lock:
+            param = self._parameters.get(name)
+        if param is None:
+            return Parameter(name, Parameter.Type.NOT_SET, None)
+        return param
+
+    def get_parameters(self, names):
+        """Get several parameters of the remote node from the mirror, in order."""
+        return [self.get_parameter(name) for name in names]
+
+    def get_parameter_names(self):
+        """Get the names of all the parameters in the mirror."""
+        with self._lock:
+            return list(self._parameters)
+
+    def destroy(self):
+        """Destroy the clients and the subscription of the mirror."""
+        self._node.destroy_subscription(self._subscription)
+        self._node.destroy_client(self._list_client)
+        self._node.destroy_client(self._get_client)
+
+    def _on_list_response(self, list_future, future):
+        if list_future.exception() is not None:
+            self._fetch_failed(list_future.exception(), future)
+            return
+        names = list(list_future.result().result.names)
+        request = GetParameters.Request()
+        request.names = names
+        get_future = self._get_client.call_async(request)
+        get_future.add_done_callback(lambda f: self._on_get_response(f, names, future))
+
+    def _on_get_response(self, get_future, names, future):
+        if get_future.exception() is not None:
+            self._fetch_failed(get_future.exception(), future)
+            return
+        parameters = {}
+        for name, value in zip(names, get_future.result().values):
+            param = Parameter.from_parameter_msg(ParameterMsg(name=name, value=value))
+            # The parameter may have been deleted between listing and getting it
+            if Parameter.Type.NOT_SET != param.type_:
+                parameters[name] = param
+        with self._lock:
+            for event in self._pending_events:
+                self._apply_event(parameters, event)
+            self._parameters = parameters
+            self._pending_events = []
+            self._fetching = False
+            self._ready = True
+        future.set_result(True)
+
+    def _fetch_failed(self, exception, future):
+        with self._lock:
+            self._fetching = False
+            self._pending_events = []
+        future.set_exception(exception)
+
+    def _on_parameter_event(self, event):
+        if event.node != self._remote_node_name:
+            return
+        with self._lock:
+            if self._fetching:
+                self._pending_events.append(event)
+            if self._ready:
+                self._apply_event(self._parameters, event)
+
+    @staticmethod
+    def _apply_event(parameters, event):
+        for param_msg in event.new_parameters:
+            parameters[param_msg.name] = Parameter.from_parameter_msg(param_msg)
+        for param_msg in event.changed_parameters:
+            parameters[param_msg.name] = Parameter.from_parameter_msg(param_msg)
+        for param_msg in event.deleted_parameters:
+            parameters.pop(param_msg.name, None)
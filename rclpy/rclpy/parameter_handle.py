@@ -0,0 +1,71 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from rclpy.parameter import Parameter
+
+_PYTHON_TYPES = {
+    bool: Parameter.Type.BOOL,
+    int: Parameter.Type.INTEGER,
+    float: Parameter.Type.DOUBLE,
+    str: Parameter.Type.STRING,
+}
+
+
+def to_parameter_type(type_):
+    """
+    Get the parameter type for a Python type.
+
+    :param type_: One of ``bool``, ``int``, ``float`` and ``str``, a
+        :class:`rclpy.parameter.Parameter.Type`, or ``None`` for any type.
+    :raises TypeError: if there is no parameter type for ``type_``.
+    """
+    if type_ is None or isinstance(type_, Parameter.Type):
+        return type_
+    try:
+        return _PYTHON_TYPES[type_]
+    except (KeyError, TypeError):
+        raise TypeError('No parameter type for {!r}'.format(type_))
+
+
+class ParameterHandle:
+    """
+    Cached view of the value of a node parameter.
+
+    The node updates :attr:`value` and increments :attr:`version` whenever the parameter is set
+    or deleted, so reading the value is a single attribute access. Code deriving values from the
+    parameter can compare :attr:`version` with the version it last used to know whether they are
+    stale. The attributes must not be modified by users.
+
+    Handles are created with :meth:`rclpy.node.Node.parameter_handle`.
+    """
+
+    __slots__ = ('name', 'type_', 'value', 'version')
+
+    def __init__(self, name, type_, parameter):
+        self.name = name
+        # Type the parameter is restricted to, or None for any type
+        self.type_ = type_
+        self.value = None
+        self.version = 0
+        self._update(parameter)
+
+    def accepts(self, parameter):
+        """Return True if the handle allows setting the parameter to ``parameter``."""
+        return (
+            self.type_ is None or parameter.type_ == self.type_ or
+            Parameter.Type.NOT_SET == parameter.type_)
+
+    def _update(self, parameter):
+        self.value = parameter.value
+        self.version += 1
@@ -0,0 +1,149 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from rclpy.parameter import PARAMETER_SEPARATOR_STRING
+
+
+class _IndexNode:
+    __slots__ = ('children', 'path', 'level', 'has_parameter', 'count')
+
+    def __init__(self, path, level):
+        self.children = {}
+        # Full dotted name of this node
+        self.path = path
+        # Number of separators in the names of parameters stored at this node
+        self.level = level
+        self.has_parameter = False
+        # Number of parameters at this node and below it
+        self.count = 0
+
+
+class ParameterIndex:
+    """
+    Trie of parameter names split on :data:`rclpy.parameter.PARAMETER_SEPARATOR_STRING`.
+
+    Listing the parameters under a prefix, up to a depth, only visits the part of the trie the
+    result comes from instead of every parameter of the node.
+    """
+
+    def __init__(self):
+        self._root = _IndexNode('', -1)
+
+    def __len__(self):
+        return self._root.count
+
+    def __contains__(self, name):
+        node = self._find(name)
+        return node is not None and node.has_parameter
+
+    def add(self, name):
+        """Add a parameter name to the index; adding a name twice has no effect."""
+        path = [self._root]
+        node = self._root
+        for segment in name.split(PARAMETER_SEPARATOR_STRING):
+            child = node.children.get(segment)
+            if child is None:
+                if node is self._root:
+                    child_path = segment
+                else:
+                    child_path = node.path + PARAMETER_SEPARATOR_STRING + segment
+                child = _IndexNode(child_path, node.level + 1)
+                node.children[segment] = child
+            node = child
+            path.append(node)
+        if node.has_parameter:
+            return
+        node.has_parameter = True
+        for n in path:
+            n.count += 1
+
+    def remove(self, name):
+        """Remove a parameter name from the index; removing an unknown name has no effect."""
+        segments = name.split(PARAMETER_SEPARATOR_STRING)
+        path = [self._root]
+        node = self._root
+        for segment in segments:
+            node = node.children.get(segment)
+            if node is None:
+                return
+            path.append(node)
+        if not node.has_parameter:
+            return
+        node.has_parameter = False
+        for n in path:
+            n.count -= 1
+        # Prune the branches left without parameters
+        for parent, segment, child in zip(reversed(path[:-1]), reversed(segments), reversed(path)):
+            if child.count:
+                break
+            del parent.children[segment]
+
+    def list(self, prefixes=(), depth=None):
+        """
+        List parameter names and the prefixes they are under.
+
+        A name is listed if it has fewer than ``depth`` separators, and if ``prefixes`` is not
+        empty, starts with one of them followed by a separator.
+
+        :param prefixes: Prefixes the names must be under, or empty to list all names.
+        :param depth: Maximum number of separators plus one, or ``None`` for no limit.
+        :returns: 2-tuple of the names, and the prefixes of the names that have one together
+            with the requested prefixes that matched any name.
+        :rtype: tuple(list(str), list(str))
+        """
+        names = []
+        result_prefixes = []
+        seen_prefixes = set()
+        if not prefixes:
+            self._collect(self._root, depth, names, result_prefixes, seen_prefixes)
+            return names, result_prefixes
+
+        seen_roots = set()
+        for prefix in prefixes:
+            node = self._find(prefix)
+            if node is None or node.path in seen_roots:
+                continue
+            seen_roots.add(node.path)
+            num_names = len(names)
+            self._collect(node, depth, names, result_prefixes, seen_prefixes)
+            if len(names) > num_names and prefix not in seen_prefixes:
+                seen_prefixes.add(prefix)
+                result_prefixes.append(prefix)
+        if len(seen_roots) > 1:
+            # Overlapping prefixes such as 'a' and 'a.b' find the same names
+            names = list(dict.fromkeys(names))
+        return names, result_prefixes
+
+    def _find(self, name):
+        node = self._root
+        for segment in name.split(PARAMETER_SEPARATOR_STRING):
+            node = node.children.get(segment)
+            if node is None:
+                return None
+        return node
+
+    def _collect(self, start, depth, names, prefixes, seen_prefixes):
+        stack = [start]
+        while stack:
+            node = stack.pop()
+            for child in node.children.values():
+                if depth is not None and child.level >= depth:
+                    break
+                if child.has_parameter:
+                    names.append(child.path)
+                    if node is not self._root and node.path not in seen_prefixes:
+                        seen_prefixes.add(node.path)
+                        prefixes.append(node.path)
+                if child.children:
+                    stack.append(child)
@@ -11,18 +11,64 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 # limitations under the License.
+from enum import IntEnum
 
 from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 
 
+class PublishQueueOverflowPolicy(IntEnum):
+    """
+    What an asynchronous publisher does when its queue is full.
+
+    This enum matches the one defined in _rclpy.c.
+    """
+
+    BLOCK = 0
+    DROP_OLDEST = 1
+    DROP_NEWEST = 2
+
+
 class Publisher:
 
-    def __init__(self, publisher_handle, msg_type, topic, qos_profile, node_handle):
+    def __init__(
+            self, publisher_handle, msg_type, topic, qos_profile, node_handle, *,
+            publish_queue_handle=None):
         self.publisher_handle = publisher_handle
         self.msg_type = msg_type
         self.topic = topic
         self.qos_profile = qos_profile
         self.node_handle = node_handle
+        # Queue drained by a background thread if the publisher is asynchronous, else None
+        self.publish_queue_handle = publish_queue_handle
 
     def publish(self, msg):
+        """
+        Publish a message.
+
+        If the publisher is asynchronous a copy of the message is queued, so the message can be
+        modified and published again right away.
+
+        :return: ``False`` if an asynchronous publisher dropped the message, else ``True``.
+        :rtype: bool
+        """
+        if self.publish_queue_handle is not None:
+            return _rclpy.rclpy_publish_queue_push(self.publish_queue_handle, msg)
         _rclpy.rclpy_publish(self.publisher_handle, msg)
+        return True
+
+    def get_publish_queue_stats(self):
+        """
+        Get the state of the queue of an asynchronous publisher.
+
+        :return: ``size``, ``capacity``, ``dropped`` and ``failed`` message counts.
+        :rtype: dict
+        :raises RuntimeError: if the publisher is not asynchronous.
+        """
+        if self.publish_queue_handle is None:
+            raise RuntimeError('Publisher is not asynchronous')
+        return _rclpy.rclpy_publish_queue_get_stats(self.publish_queue_handle)
+
+    def _stop_publish_queue(self):
+        # Publish what is queued and join the thread before the publisher is destroyed
+        if self.publish_queue_handle is not None:
+            _rclpy.rclpy_publish_queue_stop(self.publish_queue_handle)
@@ -12,13 +12,18 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from concurrent.futures import ThreadPoolExecutor
+import threading
+import traceback
+
 from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 
 
 class Service:
     def __init__(
             self, node_handle, service_handle, service_pointer,
-            srv_type, srv_name, callback, callback_group, qos_profile):
+            srv_type, srv_name, callback, callback_group, qos_profile, *,
+            max_concurrency=None):
         self.node_handle = node_handle
         self.service_handle = service_handle
         self.service_pointer = service_pointer
@@ -29,6 +34,78 @@ class Service:
         # True when the callback is ready to fire but has not been "taken" by an executor
         self._executor_event = False
         self.qos_profile = qos_profile
+        # Requests are handled on a pool of this many threads if not None
+        self.max_concurrency = max_concurrency
+        self._workers = None
+        self._in_flight = 0
+        # Set once the workers are stopped, requests taken after that are dropped
+        self._stopped = False
+        self._lock = threading.Lock()
+        if max_concurrency is not None:
+            self._workers = ThreadPoolExecutor(max_workers=max_concurrency)
 
     def send_response(self, response, header):
         _rclpy.rclpy_send_response(self.service_handle, response, header)
+
+    def _has_capacity(self):
+        """Return ``False`` while every worker of a concurrent service is busy or stopped."""
+        if self.max_concurrency is None:
+            return True
+        with self._lock:
+            return not self._stopped and self._in_flight < self.max_concurrency
+
+    def _take_requests(self):
+        """
+        Take as many queued requests as there are idle workers.
+
+        :returns: list of ``(request, header)`` pairs, each of which holds a worker slot until
+            it is passed to :meth:`_dispatch`.
+        """
+        requests = []
+        with self._lock:
+            while not self._stopped and self._in_flight < self.max_concurrency:
+                request_and_header = _rclpy.rclpy_take_request(
+                    self.service_handle, self.srv_type.Request)
+                if request_and_header is None:
+                    break
+                requests.append(request_and_header)
+                self._in_flight += 1
+        return requests
+
+    def _dispatch(self, requests, executor):
+        with self._lock:
+            if self._stopped:
+                # The service is being destroyed, its clients get no response
+                self._in_flight -= len(requests)
+                return
+            for request, header in requests:
+                self._workers.submit(self._handle_request, request, header, executor)
+
+    def _handle_request(self, request, header, executor):
+        try:
+            response = self.callback(request, self.srv_type.Response())
+            self.send_response(response, header)
+        except Exception:
+            # There is no caller to raise into; the client never gets a response
+            traceback.print_exc()
+        finally:
+            with self._lock:
+                was_full = self._in_flight == self.max_concurrency
+                self._in_flight -= 1
+            if was_full:
+                # The executor stopped waiting on this service while it was full
+                executor.wake()
+
+    def _stop_workers(self):
+        """
+        Wait until every request taken so far is handled and its response sent.
+
+        Requests are only taken when a worker is idle, so none wait long in the pool's queue.
+        Requests taken but not dispatched yet are dropped.
+        """
+        with self._lock:
+            self._stopped = True
+            workers = self._workers
+            self._workers = None
+        if workers is not None:
+            workers.shutdown(wait=True)
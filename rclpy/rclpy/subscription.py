@@ -12,12 +12,31 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from collections import namedtuple
+
+from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
+
+
+class MessageInfo(namedtuple('MessageInfo', ['publisher_gid', 'from_intra_process'])):
+    """
+    Middleware information about a taken message.
+
+    :ivar publisher_gid: Global identifier of the publisher of the message.
+    :vartype publisher_gid: bytes
+    :ivar from_intra_process: ``True`` if the message was published from the same process.
+    :vartype from_intra_process: bool
+    """
+
+    __slots__ = ()
+
 
 class Subscription:
 
     def __init__(
             self, subscription_handle, subscription_pointer,
-            msg_type, topic, callback, callback_group, qos_profile, node_handle):
+            msg_type, topic, callback, callback_group, qos_profile, node_handle, *,
+            content_filter=None, content_filter_handle=None, keep_latest=False,
+            message_info=False, latency_tracker_handle=None):
         self.node_handle = node_handle
         self.subscription_handle = subscription_handle
         self.subscription_pointer = subscription_pointer
@@ -28,3 +47,35 @@ class Subscription:
         # True when the callback is ready to fire but has not been "taken" by an executor
         self._executor_event = False
         self.qos_profile = qos_profile
+        # Filter expression, and the handle rclpy_take uses to drop samples before conversion
+        self.content_filter = content_filter
+        self.content_filter_handle = content_filter_handle
+        # True to drop all but the newest pending message each time the subscription is taken
+        self.keep_latest = keep_latest
+        # True to call the callback with a MessageInfo as second argument
+        self.message_info = message_info
+        # Handle rclpy_take records the latency of every taken message in, or None
+        self.latency_tracker_handle = latency_tracker_handle
+
+    def get_latency_stats(self):
+        """
+        Get the latency histogram recorded since creation or the last reset.
+
+        Latency is the system time at which a message was taken minus its stamp.
+        Messages with a zero stamp or a stamp in the future are only counted.
+
+        :return: ``count``, ``negative_count``, ``unstamped_count``, ``min_ns``, ``max_ns``,
+            ``mean_ns`` and ``buckets``, a list of ``(upper_bound_ns, count)`` with exponentially
+            growing bounds where the last bound is ``None``.
+        :rtype: dict
+        :raises RuntimeError: if the subscription was created without latency tracking.
+        """
+        if self.latency_tracker_handle is None:
+            raise RuntimeError('Latency tracking is not enabled on this subscription')
+        return _rclpy.rclpy_latency_tracker_get_stats(self.latency_tracker_handle)
+
+    def reset_latency_stats(self):
+        """Clear the latency histogram."""
+        if self.latency_tracker_handle is None:
+            raise RuntimeError('Latency tracking is not enabled on this subscription')
+        _rclpy.rclpy_latency_tracker_reset(self.latency_tracker_handle)
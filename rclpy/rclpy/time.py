@@ -12,13 +12,25 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import functools
+
 import builtin_interfaces
 from rclpy.clock import ClockType
 from rclpy.duration import Duration
 from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 
 
-class Time:
+class Time(_rclpy.TimePoint):
+    """
+    A point in time of a clock.
+
+    Storage, arithmetic and comparisons are implemented by the C base class.
+    """
+
+    __slots__ = ()
+
+    # Type of the difference between two times
+    _duration_type = Duration
 
     def __init__(self, *, seconds=0, nanoseconds=0, clock_type=ClockType.SYSTEM_TIME):
         if not isinstance(clock_type, ClockType):
@@ -30,15 +42,10 @@ class Time:
         total_nanoseconds = int(seconds * 1e9)
         total_nanoseconds += int(nanoseconds)
         try:
-            self._time_handle = _rclpy.rclpy_create_time_point(total_nanoseconds, clock_type)
+            super().__init__(total_nanoseconds, clock_type)
         except OverflowError as e:
             raise OverflowError(
                 'Total nanoseconds value is too large to store in C time point.') from e
-        self._clock_type = clock_type
-
-    @property
-    def nanoseconds(self):
-        return _rclpy.rclpy_time_point_get_nanoseconds(self._time_handle)
 
     def seconds_nanoseconds(self):
         """
@@ -50,87 +57,16 @@ class Time:
         nanoseconds = self.nanoseconds
         return (int(nanoseconds / 1e9), nanoseconds % 1e9)
 
-    @property
-    def clock_type(self):
-        return self._clock_type
-
     def __repr__(self):
         return 'Time(nanoseconds={0}, clock_type={1})'.format(
             self.nanoseconds, self.clock_type.name)
 
-    def __add__(self, other):
-        if isinstance(other, Duration):
-            try:
-                return Time(
-                    nanoseconds=(self.nanoseconds + other.nanoseconds),
-                    clock_type=self.clock_type)
-            except OverflowError as e:
-                raise OverflowError('Addition leads to overflow in C storage.') from e
-        else:
-            return NotImplemented
-
-    def __radd__(self, other):
-        return self.__add__(other)
-
-    def __sub__(self, other):
-        if isinstance(other, Time):
-            if self.clock_type != other.clock_type:
-                raise TypeError("Can't subtract times with different clock types")
-            try:
-                return Duration(nanoseconds=(self.nanoseconds - other.nanoseconds))
-            except ValueError as e:
-                raise ValueError('Subtraction leads to negative duration.') from e
-        if isinstance(other, Duration):
-            try:
-                return Time(
-                    nanoseconds=(self.nanoseconds - other.nanoseconds),
-                    clock_type=self.clock_type)
-            except ValueError as e:
-                raise ValueError('Subtraction leads to negative time.') from e
-        else:
-            return NotImplemented
-
-    def __eq__(self, other):
-        if isinstance(other, Time):
-            if self.clock_type != other.clock_type:
-                raise TypeError("Can't compare times with different clock types")
-            return self.nanoseconds == other.nanoseconds
-        # Raise instead of returning NotImplemented to prevent comparison with invalid types,
-        # e.g. ints.
-        # Otherwise `Time(nanoseconds=5) == 5` will return False instead of raising, and this
-        # could lead to hard-to-find bugs.
-        raise TypeError("Can't compare time with object of type: ", type(other))
-
-    def __ne__(self, other):
-        return not self.__eq__(other)
-
-    def __lt__(self, other):
-        if isinstance(other, Time):
-            if self.clock_type != other.clock_type:
-                raise TypeError("Can't compare times with different clock types")
-            return self.nanoseconds < other.nanoseconds
-        return NotImplemented
-
-    def __le__(self, other):
-        if isinstance(other, Time):
-            if self.clock_type != other.clock_type:
-                raise TypeError("Can't compare times with different clock types")
-            return self.nanoseconds <= other.nanoseconds
-        return NotImplemented
-
-    def __gt__(self, other):
-        if isinstance(other, Time):
-            if self.clock_type != other.clock_type:
-                raise TypeError("Can't compare times with different clock types")
-            return self.nanoseconds > other.nanoseconds
-        return NotImplemented
-
-    def __ge__(self, other):
-        if isinstance(other, Time):
-            if self.clock_type != other.clock_type:
-                raise TypeError("Can't compare times with different clock types")
-            return self.nanoseconds >= other.nanoseconds
-        return NotImplemented
+    def __reduce__(self):
+        # The C base class can't be pickled or copied, rebuild the time from its value
+        return (
+            functools.partial(
+                type(self), nanoseconds=self.nanoseconds, clock_type=self.clock_type),
+            ())
 
     def to_msg(self):
         seconds = int(self.nanoseconds * 1e-9)
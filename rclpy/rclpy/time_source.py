@@ -15,6 +15,8 @@
 import builtin_interfaces.msg
 from rclpy.clock import ClockType
 from rclpy.clock import ROSClock
+from rclpy.constants import S_TO_NS
+from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 from rclpy.time import Time
 
 CLOCK_TOPIC = '/clock'
@@ -26,8 +28,10 @@ class TimeSource:
         self._clock_sub = None
         self._node = None
         self._associated_clocks = []
+        # Native handle to the associated clocks, so /clock updates them in one call
+        self._clock_group = _rclpy.rclpy_create_clock_group()
         # Zero time is a special value that means time is uninitialzied
-        self._last_time_set = Time(clock_type=ClockType.ROS_TIME)
+        self._last_time_set_ns = 0
         self._ros_time_is_active = False
         if node is not None:
             self.attach_node(node)
@@ -78,13 +82,14 @@ class TimeSource:
         if not isinstance(clock, ROSClock):
             raise ValueError('Only clocks with type ROS_TIME can be attached.')
 
-        clock.set_ros_time_override(self._last_time_set)
+        clock.set_ros_time_override(
+            Time(nanoseconds=self._last_time_set_ns, clock_type=ClockType.ROS_TIME))
         clock._set_ros_time_is_active(self.ros_time_is_active)
+        _rclpy.rclpy_clock_group_add(self._clock_group, clock._clock_handle)
         self._associated_clocks.append(clock)
 
     def clock_callback(self, msg):
         # Cache the last message in case a new clock is attached.
-        time_from_msg = Time.from_msg(msg)
-        self._last_time_set = time_from_msg
-        for clock in self._associated_clocks:
-            clock.set_ros_time_override(time_from_msg)
+        nanoseconds = msg.sec * S_TO_NS + msg.nanosec
+        self._last_time_set_ns = nanoseconds
+        _rclpy.rclpy_clock_group_set_ros_time_override(self._clock_group, nanoseconds)
@@ -18,13 +18,23 @@ from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 from rclpy.utilities import get_default_context
 
 
-# TODO(mikaelarguedas) create a Timer or ROSTimer once we can specify custom time sources
-class WallTimer:
+class Timer:
 
-    def __init__(self, callback, callback_group, timer_period_ns, *, context=None):
+    def __init__(self, callback, callback_group, timer_period_ns, clock, *, context=None):
+        """
+        Create a timer driven by the given clock.
+
+        A timer on a :class:`rclpy.clock.ROSClock` follows simulated time while ROS time is
+        active: it becomes ready when the clock's ROS time override reaches its deadline, and
+        waiting executors are woken by each update of the override instead of polling.
+
+        :param clock: Clock the timer measures its period with. The clock must outlive the
+            timer.
+        """
         self._context = get_default_context() if context is None else context
-        # TODO(sloretz) Allow passing clocks in via timer constructor
-        self._clock = Clock(clock_type=ClockType.STEADY_TIME)
+        self._clock = clock
+        # True if the timer created its clock and destroying the timer destroys the clock
+        self._owns_clock = False
         [self.timer_handle, self.timer_pointer] = _rclpy.rclpy_create_timer(
             self._clock._clock_handle, self._context.handle, timer_period_ns)
         self.timer_period_ns = timer_period_ns
@@ -66,3 +76,12 @@ class WallTimer:
 
     def time_until_next_call(self):
         return _rclpy.rclpy_time_until_next_call(self.timer_handle)
+
+
+class WallTimer(Timer):
+
+    def __init__(self, callback, callback_group, timer_period_ns, *, context=None):
+        super().__init__(
+            callback, callback_group, timer_period_ns, Clock(clock_type=ClockType.STEADY_TIME),
+            context=context)
+        self._owns_clock = True
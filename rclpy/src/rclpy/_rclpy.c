@@ -32,6 +32,10 @@
 #include <rmw/validate_namespace.h>
 #include <rmw/validate_node_name.h>
 #include <rosidl_generator_c/message_type_support_struct.h>
+#include <rosidl_generator_c/string.h>
+#include <rosidl_typesupport_introspection_c/field_types.h>
+#include <rosidl_typesupport_introspection_c/identifier.h>
+#include <rosidl_typesupport_introspection_c/message_introspection.h>
 
 #include <signal.h>
 
@@ -1204,6 +1208,81 @@ rclpy_create_publisher(PyObject * Py_UNUSED(self), PyObject * args)
   return PyCapsule_New(publisher, "rcl_publisher_t", NULL);
 }
 
+/// Convert a Python message to a ROS message
+/**
+ * \param[in] pymsg message to convert
+ * \param[out] destroy_ros_message set to the function destroying the returned message
+ * \return the ROS message, or
+ * \return NULL with a Python error set
+ */
+static void *
+_convert_pymsg(PyObject * pymsg, destroy_ros_message_signature ** destroy_ros_message)
+{
+  PyObject * pymsg_type = PyObject_GetAttrString(pymsg, "__class__");
+
+  PyObject * pymetaclass = PyObject_GetAttrString(pymsg_type, "__class__");
+  Py_DECREF(pymsg_type);
+
+  create_ros_message_signature * create_ros_message = get_capsule_pointer(
+    pymetaclass, "_CREATE_ROS_MESSAGE");
+  assert(create_ros_message != NULL &&
+    "unable to retrieve create_ros_message function, type_support mustn't have been imported");
+
+  *destroy_ros_message = get_capsule_pointer(pymetaclass, "_DESTROY_ROS_MESSAGE");
+  assert(*destroy_ros_message != NULL &&
+    "unable to retrieve destroy_ros_message function, type_support mustn't have been imported");
+
+  convert_from_py_signature * convert_from_py = get_capsule_pointer(
+    pymetaclass, "_CONVERT_FROM_PY");
+  assert(convert_from_py != NULL &&
+    "unable to retrieve convert_from_py function, type_support mustn't have been imported");
+
+  Py_DECREF(pymetaclass);
+
+  void * raw_ros_message = create_ros_message();
+  if (!raw_ros_message) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+
+  if (!convert_from_py(pymsg, raw_ros_message)) {
+    // the function has set the Python error
+    (*destroy_ros_message)(raw_ros_message);
+    return NULL;
+  }
+  return raw_ros_message;
+}
+
+/// Publish a ROS message
+/**
+ * Raises RuntimeError if the message cannot be published
+ *
+ * \param[in] publisher the publisher to publish with
+ * \param[in] raw_ros_message message to send
+ * \param[in] release_gil true to release the GIL around rcl_publish
+ * \return true on success, or
+ * \return false with a Python error set
+ */
+static bool
+_publish_ros_message(rcl_publisher_t * publisher, void * raw_ros_message, bool release_gil)
+{
+  rcl_ret_t ret;
+  if (release_gil) {
+    Py_BEGIN_ALLOW_THREADS;
+    ret = rcl_publish(publisher, raw_ros_message);
+    Py_END_ALLOW_THREADS;
+  } else {
+    ret = rcl_publish(publisher, raw_ros_message);
+  }
+  if (ret != RCL_RET_OK) {
+    PyErr_Format(PyExc_RuntimeError,
+      "Failed to publish: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+    return false;
+  }
+  return true;
+}
+
 /// Publish a message
 /**
  * Raises ValueError if pypublisher is not a publisher capsule
@@ -1229,51 +1308,436 @@ rclpy_publish(PyObject * Py_UNUSED(self), PyObject * args)
     return NULL;
   }
 
-  PyObject * pymsg_type = PyObject_GetAttrString(pymsg, "__class__");
+  destroy_ros_message_signature * destroy_ros_message;
+  void * raw_ros_message = _convert_pymsg(pymsg, &destroy_ros_message);
+  if (!raw_ros_message) {
+    return NULL;
+  }
+  bool published = _publish_ros_message(publisher, raw_ros_message, false);
+  destroy_ros_message(raw_ros_message);
+  if (!published) {
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
 
-  PyObject * pymetaclass = PyObject_GetAttrString(pymsg_type, "__class__");
-  Py_DECREF(pymsg_type);
+#if PY_VERSION_HEX >= 0x030D0000
+# define RCLPY_IS_FINALIZING() Py_IsFinalizing()
+#elif PY_VERSION_HEX >= 0x03070000
+# define RCLPY_IS_FINALIZING() _Py_IsFinalizing()
+#else
+# define RCLPY_IS_FINALIZING() (_Py_Finalizing != NULL)
+#endif
 
-  create_ros_message_signature * create_ros_message = get_capsule_pointer(
-    pymetaclass, "_CREATE_ROS_MESSAGE");
-  assert(create_ros_message != NULL &&
-    "unable to retrieve create_ros_message function, type_support mustn't have been imported");
+typedef enum
+{
+  RCLPY_PUBLISH_QUEUE_BLOCK,
+  RCLPY_PUBLISH_QUEUE_DROP_OLDEST,
+  RCLPY_PUBLISH_QUEUE_DROP_NEWEST,
+} rclpy_publish_queue_policy_t;
 
-  destroy_ros_message_signature * destroy_ros_message = get_capsule_pointer(
-    pymetaclass, "_DESTROY_ROS_MESSAGE");
-  assert(destroy_ros_message != NULL &&
-    "unable to retrieve destroy_ros_message function, type_support mustn't have been imported");
+/// ROS message waiting in a publish queue
+typedef struct
+{
+  void * ros_message;
+  destroy_ros_message_signature * destroy_ros_message;
+} rclpy_publish_queue_item_t;
 
-  convert_from_py_signature * convert_from_py = get_capsule_pointer(
-    pymetaclass, "_CONVERT_FROM_PY");
-  assert(convert_from_py != NULL &&
-    "unable to retrieve convert_from_py function, type_support mustn't have been imported");
+/// Bounded queue of messages published by a background thread
+/**
+ * Messages are converted when they are queued, so the queue holds a snapshot of each message
+ * and the Python message can be reused right away.
+ *
+ * All fields except the locks are only accessed with the GIL held, so the GIL is what protects
+ * the queue. The locks are used as binary events to sleep without the GIL: each is released
+ * only if the matching *_waiting flag was set, and the flag is cleared when it is.
+ */
+typedef struct
+{
+  rcl_publisher_t * publisher;
+  /// Reference to the publisher capsule, to keep it alive while the thread publishes
+  PyObject * pypublisher;
+  rclpy_publish_queue_policy_t policy;
+  /// Ring buffer of the queued messages
+  rclpy_publish_queue_item_t * items;
+  size_t capacity;
+  size_t head;
+  size_t size;
+  /// Messages dropped because the queue was full
+  uint64_t dropped;
+  /// Messages which failed to be published
+  uint64_t failed;
+  /// True while the background thread is running and accepting messages
+  bool running;
+  bool worker_waiting;
+  PyThread_type_lock items_event;
+  bool producer_waiting;
+  PyThread_type_lock space_event;
+  /// Serializes producers blocking for space, so at most one waits on space_event
+  PyThread_type_lock producer_lock;
+  /// Released by the background thread when it exits
+  PyThread_type_lock done_event;
+} rclpy_publish_queue_t;
+
+static void
+_publish_queue_wake_worker(rclpy_publish_queue_t * queue)
+{
+  if (queue->worker_waiting) {
+    queue->worker_waiting = false;
+    PyThread_release_lock(queue->items_event);
+  }
+}
 
-  Py_DECREF(pymetaclass);
+static void
+_publish_queue_wake_producer(rclpy_publish_queue_t * queue)
+{
+  if (queue->producer_waiting) {
+    queue->producer_waiting = false;
+    PyThread_release_lock(queue->space_event);
+  }
+}
 
-  void * raw_ros_message = create_ros_message();
-  if (!raw_ros_message) {
+static rclpy_publish_queue_item_t
+_publish_queue_pop(rclpy_publish_queue_t * queue)
+{
+  rclpy_publish_queue_item_t item = queue->items[queue->head];
+  queue->items[queue->head].ros_message = NULL;
+  queue->head = (queue->head + 1) % queue->capacity;
+  queue->size--;
+  return item;
+}
+
+/// Body of the background thread of a publish queue
+/**
+ * Publishes messages until the queue is stopped and empty.
+ * The queue is accessed with the GIL, rcl_publish is called without it.
+ */
+static void
+_publish_queue_thread(void * arg)
+{
+  rclpy_publish_queue_t * queue = (rclpy_publish_queue_t *)arg;
+  PyGILState_STATE gstate = PyGILState_Ensure();
+  while (true) {
+    if (0 == queue->size) {
+      if (!queue->running) {
+        break;
+      }
+      queue->worker_waiting = true;
+      Py_BEGIN_ALLOW_THREADS;
+      PyThread_acquire_lock(queue->items_event, WAIT_LOCK);
+      Py_END_ALLOW_THREADS;
+      continue;
+    }
+    rclpy_publish_queue_item_t item = _publish_queue_pop(queue);
+    _publish_queue_wake_producer(queue);
+    if (!_publish_ros_message(queue->publisher, item.ros_message, true)) {
+      queue->failed++;
+      // There is no caller to raise to
+      PyErr_WriteUnraisable(queue->pypublisher);
+    }
+    item.destroy_ros_message(item.ros_message);
+  }
+  // The owner frees the queue once this is released, don't touch it afterwards
+  PyThread_release_lock(queue->done_event);
+  PyGILState_Release(gstate);
+}
+
+/// Stop the background thread of a publish queue, after it published the queued messages
+static void
+_publish_queue_stop(rclpy_publish_queue_t * queue)
+{
+  if (!queue->running) {
+    return;
+  }
+  queue->running = false;
+  _publish_queue_wake_worker(queue);
+  _publish_queue_wake_producer(queue);
+  Py_BEGIN_ALLOW_THREADS;
+  PyThread_acquire_lock(queue->done_event, WAIT_LOCK);
+  Py_END_ALLOW_THREADS;
+}
+
+static void
+_publish_queue_fini(rclpy_publish_queue_t * queue)
+{
+  if (queue->items) {
+    for (size_t i = 0; i < queue->capacity; ++i) {
+      if (queue->items[i].ros_message) {
+        queue->items[i].destroy_ros_message(queue->items[i].ros_message);
+      }
+    }
+    PyMem_Free(queue->items);
+  }
+  if (queue->items_event) {
+    PyThread_free_lock(queue->items_event);
+  }
+  if (queue->space_event) {
+    PyThread_free_lock(queue->space_event);
+  }
+  if (queue->producer_lock) {
+    PyThread_free_lock(queue->producer_lock);
+  }
+  if (queue->done_event) {
+    PyThread_free_lock(queue->done_event);
+  }
+  Py_XDECREF(queue->pypublisher);
+  PyMem_Free(queue);
+}
+
+/// Destructor for a publish queue
+void
+_rclpy_destroy_publish_queue(PyObject * pycapsule)
+{
+  rclpy_publish_queue_t * queue = (rclpy_publish_queue_t *)PyCapsule_GetPointer(
+    pycapsule, "rclpy_publish_queue_t");
+  if (!queue) {
+    PyErr_Clear();
+    return;
+  }
+  if (RCLPY_IS_FINALIZING()) {
+    // The background thread can't take the GIL anymore to exit, so it can't be joined
+    return;
+  }
+  _publish_queue_stop(queue);
+  _publish_queue_fini(queue);
+}
+
+/// Create a publish queue with its background thread
+/**
+ * Raises ValueError if pypublisher is not a publisher capsule, capacity is 0 or the policy is
+ * unknown
+ * Raises RuntimeError if the background thread could not be started
+ *
+ * \param[in] pypublisher Capsule pointing to the publisher
+ * \param[in] capacity maximum number of messages waiting to be published
+ * \param[in] policy what to do when the queue is full: 0 blocks the caller, 1 drops the oldest
+ *   queued message, 2 drops the new message
+ * \return Capsule pointing to the created rclpy_publish_queue_t, or
+ * \return NULL on failure
+ */
+static PyObject *
+rclpy_create_publish_queue(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pypublisher;
+  Py_ssize_t capacity;
+  int policy;
+
+  if (!PyArg_ParseTuple(args, "Oni", &pypublisher, &capacity, &policy)) {
+    return NULL;
+  }
+
+  rcl_publisher_t * publisher = (rcl_publisher_t *)PyCapsule_GetPointer(
+    pypublisher, "rcl_publisher_t");
+  if (!publisher) {
+    return NULL;
+  }
+  if (capacity < 1) {
+    PyErr_Format(PyExc_ValueError, "Publish queue capacity must be at least 1");
+    return NULL;
+  }
+  if (policy < RCLPY_PUBLISH_QUEUE_BLOCK || policy > RCLPY_PUBLISH_QUEUE_DROP_NEWEST) {
+    PyErr_Format(PyExc_ValueError, "Unknown publish queue overflow policy %d", policy);
+    return NULL;
+  }
+
+  rclpy_publish_queue_t * queue =
+    (rclpy_publish_queue_t *)PyMem_Calloc(1, sizeof(rclpy_publish_queue_t));
+  if (!queue) {
     return PyErr_NoMemory();
   }
+  queue->publisher = publisher;
+  Py_INCREF(pypublisher);
+  queue->pypublisher = pypublisher;
+  queue->policy = (rclpy_publish_queue_policy_t)policy;
+  queue->capacity = (size_t)capacity;
+  queue->items = (rclpy_publish_queue_item_t *)PyMem_Calloc(
+    queue->capacity, sizeof(rclpy_publish_queue_item_t));
+  queue->items_event = PyThread_allocate_lock();
+  queue->space_event = PyThread_allocate_lock();
+  queue->producer_lock = PyThread_allocate_lock();
+  queue->done_event = PyThread_allocate_lock();
+  if (!queue->items || !queue->items_event || !queue->space_event || !queue->producer_lock ||
+    !queue->done_event)
+  {
+    _publish_queue_fini(queue);
+    return PyErr_NoMemory();
+  }
+  // Events start unsignaled
+  PyThread_acquire_lock(queue->items_event, WAIT_LOCK);
+  PyThread_acquire_lock(queue->space_event, WAIT_LOCK);
+  PyThread_acquire_lock(queue->done_event, WAIT_LOCK);
 
-  if (!convert_from_py(pymsg, raw_ros_message)) {
-    // the function has set the Python error
+  PyObject * pyqueue = PyCapsule_New(queue, "rclpy_publish_queue_t", NULL);
+  if (!pyqueue) {
+    _publish_queue_fini(queue);
+    return NULL;
+  }
+
+#if PY_VERSION_HEX < 0x03070000
+  // The GIL is only created at startup since Python 3.7
+  PyEval_InitThreads();
+#endif
+  queue->running = true;
+  if (PyThread_start_new_thread(_publish_queue_thread, queue) == (unsigned long)-1) {
+    queue->running = false;
+    Py_DECREF(pyqueue);
+    _publish_queue_fini(queue);
+    PyErr_Format(PyExc_RuntimeError, "Failed to start the publish queue thread");
+    return NULL;
+  }
+  if (PyCapsule_SetDestructor(pyqueue, _rclpy_destroy_publish_queue)) {
+    _publish_queue_stop(queue);
+    Py_DECREF(pyqueue);
+    _publish_queue_fini(queue);
+    return NULL;
+  }
+  return pyqueue;
+}
+
+/// Queue a message to be published by the background thread
+/**
+ * The message is converted before it is queued, so it can be modified afterwards.
+ * If the queue is full the overflow policy decides which message is dropped, or blocks without
+ * the GIL until there is space.
+ *
+ * Raises ValueError if pyqueue is not a publish queue capsule
+ * Raises RuntimeError if the queue was stopped
+ * Raises the error of the conversion if the message cannot be converted
+ *
+ * \param[in] pyqueue Capsule pointing to the publish queue
+ * \param[in] pymsg message to send
+ * \return True if the message was queued, False if it was dropped
+ */
+static PyObject *
+rclpy_publish_queue_push(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pyqueue;
+  PyObject * pymsg;
+
+  if (!PyArg_ParseTuple(args, "OO", &pyqueue, &pymsg)) {
+    return NULL;
+  }
+
+  rclpy_publish_queue_t * queue = (rclpy_publish_queue_t *)PyCapsule_GetPointer(
+    pyqueue, "rclpy_publish_queue_t");
+  if (!queue) {
+    return NULL;
+  }
+
+  if (queue->running && queue->size == queue->capacity &&
+    RCLPY_PUBLISH_QUEUE_DROP_NEWEST == queue->policy)
+  {
+    // Don't convert a message that is dropped anyway
+    queue->dropped++;
+    Py_RETURN_FALSE;
+  }
+
+  // Conversion can run Python code letting other threads push, so it is done first
+  destroy_ros_message_signature * destroy_ros_message;
+  void * raw_ros_message = _convert_pymsg(pymsg, &destroy_ros_message);
+  if (!raw_ros_message) {
+    return NULL;
+  }
+
+  if (queue->running && queue->size == queue->capacity) {
+    switch (queue->policy) {
+      case RCLPY_PUBLISH_QUEUE_DROP_NEWEST:
+        queue->dropped++;
+        destroy_ros_message(raw_ros_message);
+        Py_RETURN_FALSE;
+      case RCLPY_PUBLISH_QUEUE_DROP_OLDEST:
+        {
+          rclpy_publish_queue_item_t oldest = _publish_queue_pop(queue);
+          oldest.destroy_ros_message(oldest.ros_message);
+        }
+        queue->dropped++;
+        break;
+      case RCLPY_PUBLISH_QUEUE_BLOCK:
+        Py_BEGIN_ALLOW_THREADS;
+        PyThread_acquire_lock(queue->producer_lock, WAIT_LOCK);
+        Py_END_ALLOW_THREADS;
+        while (queue->running && queue->size == queue->capacity) {
+          queue->producer_waiting = true;
+          Py_BEGIN_ALLOW_THREADS;
+          PyThread_acquire_lock(queue->space_event, WAIT_LOCK);
+          Py_END_ALLOW_THREADS;
+        }
+        PyThread_release_lock(queue->producer_lock);
+        break;
+    }
+  }
+  if (!queue->running) {
     destroy_ros_message(raw_ros_message);
+    PyErr_Format(PyExc_RuntimeError, "Publish queue was stopped");
     return NULL;
   }
 
-  rcl_ret_t ret = rcl_publish(publisher, raw_ros_message);
-  destroy_ros_message(raw_ros_message);
-  if (ret != RCL_RET_OK) {
-    PyErr_Format(PyExc_RuntimeError,
-      "Failed to publish: %s", rcl_get_error_string().str);
-    rcl_reset_error();
+  rclpy_publish_queue_item_t * item =
+    &queue->items[(queue->head + queue->size) % queue->capacity];
+  item->ros_message = raw_ros_message;
+  item->destroy_ros_message = destroy_ros_message;
+  queue->size++;
+  _publish_queue_wake_worker(queue);
+  Py_RETURN_TRUE;
+}
+
+/// Stop a publish queue once the queued messages are published
+/**
+ * Waits without the GIL for the background thread to publish the queued messages and exit.
+ * Messages pushed afterwards raise RuntimeError. Stopping a stopped queue does nothing.
+ *
+ * Raises ValueError if pyqueue is not a publish queue capsule
+ *
+ * \param[in] pyqueue Capsule pointing to the publish queue
+ * \return None
+ */
+static PyObject *
+rclpy_publish_queue_stop(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pyqueue;
+
+  if (!PyArg_ParseTuple(args, "O", &pyqueue)) {
     return NULL;
   }
 
+  rclpy_publish_queue_t * queue = (rclpy_publish_queue_t *)PyCapsule_GetPointer(
+    pyqueue, "rclpy_publish_queue_t");
+  if (!queue) {
+    return NULL;
+  }
+  _publish_queue_stop(queue);
   Py_RETURN_NONE;
 }
 
+/// Get the state of a publish queue
+/**
+ * Raises ValueError if pyqueue is not a publish queue capsule
+ *
+ * \param[in] pyqueue Capsule pointing to the publish queue
+ * \return dict with the keys 'size', 'capacity', 'dropped' and 'failed'
+ */
+static PyObject *
+rclpy_publish_queue_get_stats(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pyqueue;
+
+  if (!PyArg_ParseTuple(args, "O", &pyqueue)) {
+    return NULL;
+  }
+
+  rclpy_publish_queue_t * queue = (rclpy_publish_queue_t *)PyCapsule_GetPointer(
+    pyqueue, "rclpy_publish_queue_t");
+  if (!queue) {
+    return NULL;
+  }
+  return Py_BuildValue(
+    "{snsnsKsK}",
+    "size", (Py_ssize_t)queue->size,
+    "capacity", (Py_ssize_t)queue->capacity,
+    "dropped", queue->dropped,
+    "failed", queue->failed);
+}
+
 /// Create a timer
 /**
  * When successful a list with two elements is returned:
@@ -1719,22 +2183,691 @@ rclpy_create_subscription(PyObject * Py_UNUSED(self), PyObject * args)
   return pylist;
 }
 
-/// Create a client
+typedef enum
+{
+  RCLPY_FILTER_OP_EQ,
+  RCLPY_FILTER_OP_NE,
+  RCLPY_FILTER_OP_LT,
+  RCLPY_FILTER_OP_LE,
+  RCLPY_FILTER_OP_GT,
+  RCLPY_FILTER_OP_GE,
+} rclpy_filter_op_t;
+
+/// A predicate on a single field of a C message, evaluated before conversion to Python
+typedef struct
+{
+  /// Byte offset of the field from the start of the message
+  size_t offset;
+  /// rosidl_typesupport_introspection_c field type id
+  uint8_t type_id;
+  rclpy_filter_op_t op;
+  /// If greater than zero the field is compared as (field % modulus)
+  int64_t modulus;
+  /// True if the operand is a float, in which case numeric fields compare as double
+  bool operand_is_double;
+  /// True if the operand is an int above INT64_MAX, stored in operand_uint
+  bool operand_is_large;
+  int64_t operand_int;
+  uint64_t operand_uint;
+  double operand_double;
+  /// Null terminated operand for string fields, owned by this structure
+  char * operand_string;
+} rclpy_content_filter_t;
+
+/// Destructor for a content filter
+void
+_rclpy_destroy_content_filter(PyObject * pycapsule)
+{
+  rclpy_content_filter_t * filter = (rclpy_content_filter_t *)PyCapsule_GetPointer(
+    pycapsule, "rclpy_content_filter_t");
+  if (!filter) {
+    PyErr_Clear();
+    return;
+  }
+  PyMem_Free(filter->operand_string);
+  PyMem_Free(filter);
+}
+
+static bool
+_content_filter_is_integral(uint8_t type_id)
+{
+  switch (type_id) {
+    case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// Find a field of a message by name using its introspection type support
 /**
- * This function will create a client for the given service name.
- * This client will use the typesupport defined in the service module
- * provided as pysrv_type to send messages over the wire.
- *
- * On a successful call a list with two elements is returned:
+ * Raises RuntimeError if the message has no introspection type support
+ * Raises ValueError if the message has no field with the given name
  *
- * - a Capsule pointing to the pointer of the created rcl_client_t * structure
- * - an integer representing the memory address of the created rcl_client_t
- *
- * Raises ValueError if the capsules are not the correct types
- * Raises RuntimeError if the client could not be created
- *
- * \param[in] pynode Capsule pointing to the node to add the client to
- * \param[in] pysrv_type Service module associated with the client
+ * \param[in] ts type support of the message
+ * \param[in] field_name name of the field
+ * \return the introspection member describing the field, or
+ * \return NULL on failure
+ */
+static const rosidl_typesupport_introspection_c__MessageMember *
+_get_message_member(const rosidl_message_type_support_t * ts, const char * field_name)
+{
+  const rosidl_message_type_support_t * introspection_ts = get_message_typesupport_handle(
+    ts, rosidl_typesupport_introspection_c__identifier);
+  if (!introspection_ts) {
+    PyErr_Format(PyExc_RuntimeError,
+      "Accessing '%s' requires the introspection type support of the message", field_name);
+    return NULL;
+  }
+  const rosidl_typesupport_introspection_c__MessageMembers * members =
+    (const rosidl_typesupport_introspection_c__MessageMembers *)introspection_ts->data;
+  for (uint32_t m = 0; m < members->member_count_; ++m) {
+    if (0 == strcmp(members->members_[m].name_, field_name)) {
+      return &members->members_[m];
+    }
+  }
+  PyErr_Format(PyExc_ValueError,
+    "Message '%s' has no field '%s'", members->message_name_, field_name);
+  return NULL;
+}
+
+/// Resolve a path of field names through nested messages
+/**
+ * Raises ValueError if a field does not exist or an intermediate field is not a message
+ * Raises RuntimeError if a message has no introspection type support
+ *
+ * \param[in] ts type support of the outermost message
+ * \param[in] pyfield_names sequence of field names from the message to the wanted field
+ * \param[out] offset byte offset of the wanted field from the start of the outermost message
+ * \return the introspection member describing the wanted field, or
+ * \return NULL on failure
+ */
+static const rosidl_typesupport_introspection_c__MessageMember *
+_resolve_message_field(
+  const rosidl_message_type_support_t * ts, PyObject * pyfield_names, size_t * offset)
+{
+  PyObject * pyfield_names_seq = PySequence_Fast(pyfield_names, "field names must be a sequence");
+  if (!pyfield_names_seq) {
+    return NULL;
+  }
+  Py_ssize_t num_fields = PySequence_Fast_GET_SIZE(pyfield_names_seq);
+  if (num_fields < 1) {
+    PyErr_Format(PyExc_ValueError, "At least one field name is required");
+    Py_DECREF(pyfield_names_seq);
+    return NULL;
+  }
+
+  *offset = 0;
+  const rosidl_typesupport_introspection_c__MessageMember * member = NULL;
+  for (Py_ssize_t i = 0; i < num_fields; ++i) {
+    const char * field_name = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(pyfield_names_seq, i));
+    if (!field_name) {
+      Py_DECREF(pyfield_names_seq);
+      return NULL;
+    }
+    if (member) {
+      // Descend into the nested message of the previous field
+      if (rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE != member->type_id_ ||
+        member->is_array_)
+      {
+        PyErr_Format(PyExc_ValueError,
+          "Field '%s' is not a message, can't access '%s'", member->name_, field_name);
+        Py_DECREF(pyfield_names_seq);
+        return NULL;
+      }
+      ts = member->members_;
+    }
+    member = _get_message_member(ts, field_name);
+    if (!member) {
+      Py_DECREF(pyfield_names_seq);
+      return NULL;
+    }
+    *offset += member->offset_;
+  }
+  Py_DECREF(pyfield_names_seq);
+  return member;
+}
+
+/// Create a content filter for a subscription
+/**
+ * The filter is resolved against the introspection type support of the message type once,
+ * so evaluating it on a taken message is a pointer offset and a comparison.
+ *
+ * Raises ValueError if a field does not exist, is an array, or can't be compared to the operand
+ * Raises TypeError if the operand type is not supported
+ * Raises RuntimeError if the message has no introspection type support
+ *
+ * \param[in] pymsg_type Message type associated with the subscription
+ * \param[in] pyfield_names sequence of field names from the message to the compared field
+ * \param[in] op string comparison operator, one of ["==", "!=", "<", "<=", ">", ">="]
+ * \param[in] pyoperand bool, int, float or str to compare the field against
+ * \param[in] modulus compare the field modulo this value if greater than 0
+ * \return Capsule pointing to the created rclpy_content_filter_t, or
+ * \return NULL on failure
+ */
+static PyObject *
+rclpy_create_content_filter(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pymsg_type;
+  PyObject * pyfield_names;
+  const char * op_string;
+  PyObject * pyoperand;
+  PY_LONG_LONG modulus;
+
+  if (!PyArg_ParseTuple(
+      args, "OOsOL", &pymsg_type, &pyfield_names, &op_string, &pyoperand, &modulus))
+  {
+    return NULL;
+  }
+
+  rclpy_filter_op_t op;
+  if (0 == strcmp(op_string, "==")) {
+    op = RCLPY_FILTER_OP_EQ;
+  } else if (0 == strcmp(op_string, "!=")) {
+    op = RCLPY_FILTER_OP_NE;
+  } else if (0 == strcmp(op_string, "<")) {
+    op = RCLPY_FILTER_OP_LT;
+  } else if (0 == strcmp(op_string, "<=")) {
+    op = RCLPY_FILTER_OP_LE;
+  } else if (0 == strcmp(op_string, ">")) {
+    op = RCLPY_FILTER_OP_GT;
+  } else if (0 == strcmp(op_string, ">=")) {
+    op = RCLPY_FILTER_OP_GE;
+  } else {
+    PyErr_Format(PyExc_ValueError, "Unknown comparison operator '%s'", op_string);
+    return NULL;
+  }
+
+  PyObject * pymetaclass = PyObject_GetAttrString(pymsg_type, "__class__");
+  if (!pymetaclass) {
+    return NULL;
+  }
+  const rosidl_message_type_support_t * ts = get_capsule_pointer(pymetaclass, "_TYPE_SUPPORT");
+  Py_DECREF(pymetaclass);
+  if (!ts) {
+    return NULL;
+  }
+
+  size_t offset;
+  const rosidl_typesupport_introspection_c__MessageMember * member =
+    _resolve_message_field(ts, pyfield_names, &offset);
+  if (!member) {
+    return NULL;
+  }
+
+  if (member->is_array_) {
+    PyErr_Format(PyExc_ValueError, "Can't filter on array field '%s'", member->name_);
+    return NULL;
+  }
+
+  rclpy_content_filter_t * filter =
+    (rclpy_content_filter_t *)PyMem_Malloc(sizeof(rclpy_content_filter_t));
+  if (!filter) {
+    return PyErr_NoMemory();
+  }
+  filter->offset = offset;
+  filter->type_id = member->type_id_;
+  filter->op = op;
+  filter->modulus = modulus;
+  filter->operand_is_double = false;
+  filter->operand_is_large = false;
+  filter->operand_int = 0;
+  filter->operand_uint = 0;
+  filter->operand_double = 0.0;
+  filter->operand_string = NULL;
+
+  if (rosidl_typesupport_introspection_c__ROS_TYPE_STRING == member->type_id_) {
+    if (!PyUnicode_Check(pyoperand) || modulus > 0) {
+      PyErr_Format(PyExc_ValueError,
+        "String field '%s' can only be compared to a str", member->name_);
+      PyMem_Free(filter);
+      return NULL;
+    }
+    Py_ssize_t size;
+    const char * operand = PyUnicode_AsUTF8AndSize(pyoperand, &size);
+    if (!operand) {
+      PyMem_Free(filter);
+      return NULL;
+    }
+    filter->operand_string = (char *)PyMem_Malloc(size + 1);
+    if (!filter->operand_string) {
+      PyMem_Free(filter);
+      return PyErr_NoMemory();
+    }
+    memcpy(filter->operand_string, operand, size + 1);
+  } else if (_content_filter_is_integral(member->type_id_) ||
+    rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT == member->type_id_ ||
+    rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE == member->type_id_)
+  {
+    if (modulus > 0 && !_content_filter_is_integral(member->type_id_)) {
+      PyErr_Format(PyExc_ValueError,
+        "Modulus can only be applied to integer field '%s'", member->name_);
+      PyMem_Free(filter);
+      return NULL;
+    }
+    if (PyFloat_Check(pyoperand)) {
+      filter->operand_is_double = true;
+      filter->operand_double = PyFloat_AS_DOUBLE(pyoperand);
+    } else if (PyLong_Check(pyoperand)) {
+      // bool is a subclass of int
+      int overflow;
+      filter->operand_int = PyLong_AsLongLongAndOverflow(pyoperand, &overflow);
+      filter->operand_double = (double)filter->operand_int;
+      if (overflow > 0) {
+        // Only uint64 fields can be equal to it, but all integer fields can be compared to it
+        filter->operand_is_large = true;
+        filter->operand_uint = PyLong_AsUnsignedLongLong(pyoperand);
+        filter->operand_double = (double)filter->operand_uint;
+      } else if (overflow < 0) {
+        PyErr_Format(PyExc_OverflowError,
+          "Operand of numeric field '%s' is too small", member->name_);
+      }
+      if (PyErr_Occurred()) {
+        PyMem_Free(filter);
+        return NULL;
+      }
+    } else {
+      PyErr_Format(PyExc_TypeError,
+        "Numeric field '%s' can only be compared to an int, float or bool", member->name_);
+      PyMem_Free(filter);
+      return NULL;
+    }
+  } else {
+    PyErr_Format(PyExc_ValueError,
+      "Field '%s' has a type which can't be filtered on", member->name_);
+    PyMem_Free(filter);
+    return NULL;
+  }
+
+  return PyCapsule_New(filter, "rclpy_content_filter_t", _rclpy_destroy_content_filter);
+}
+
+#define RCLPY_FILTER_COMPARE(LHS, RHS, OP) \
+  ((RCLPY_FILTER_OP_EQ == (OP)) ? ((LHS) == (RHS)) : \
+  (RCLPY_FILTER_OP_NE == (OP)) ? ((LHS) != (RHS)) : \
+  (RCLPY_FILTER_OP_LT == (OP)) ? ((LHS) < (RHS)) : \
+  (RCLPY_FILTER_OP_LE == (OP)) ? ((LHS) <= (RHS)) : \
+  (RCLPY_FILTER_OP_GT == (OP)) ? ((LHS) > (RHS)) : \
+  ((LHS) >= (RHS)))
+
+#define RCLPY_FILTER_THREE_WAY(LHS, RHS) (((LHS) < (RHS)) ? -1 : ((LHS) > (RHS)) ? 1 : 0)
+
+/// Evaluate a content filter on a C message
+/**
+ * \param[in] filter the filter to evaluate
+ * \param[in] ros_message the C message to inspect
+ * \return true if the message passes the filter
+ */
+static bool
+_content_filter_matches(const rclpy_content_filter_t * filter, const void * ros_message)
+{
+  const char * field = (const char *)ros_message + filter->offset;
+  int64_t int_value = 0;
+  // uint64 fields are kept unsigned, their values above INT64_MAX don't fit int_value
+  uint64_t uint_value = 0;
+  bool is_uint = false;
+  double double_value = 0.0;
+  bool is_double = false;
+  switch (filter->type_id) {
+    case rosidl_typesupport_introspection_c__ROS_TYPE_STRING:
+      {
+        const rosidl_generator_c__String * string = (const rosidl_generator_c__String *)field;
+        int cmp = strcmp(string->data ? string->data : "", filter->operand_string);
+        return RCLPY_FILTER_COMPARE(cmp, 0, filter->op);
+      }
+    case rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT:
+      double_value = *(const float *)field;
+      is_double = true;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE:
+      double_value = *(const double *)field;
+      is_double = true;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+      int_value = *(const bool *)field;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+      int_value = *(const uint8_t *)field;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+      int_value = *(const int8_t *)field;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+      int_value = *(const uint16_t *)field;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+      int_value = *(const int16_t *)field;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+      int_value = *(const uint32_t *)field;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+      int_value = *(const int32_t *)field;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+      uint_value = *(const uint64_t *)field;
+      is_uint = true;
+      break;
+    case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+      int_value = *(const int64_t *)field;
+      break;
+    default:
+      // Rejected when the filter was created
+      return true;
+  }
+  if (filter->modulus > 0) {
+    if (is_uint) {
+      uint_value %= (uint64_t)filter->modulus;
+    } else {
+      int_value %= filter->modulus;
+      if (int_value < 0) {
+        int_value += filter->modulus;
+      }
+    }
+  }
+  if (is_double || filter->operand_is_double) {
+    if (!is_double) {
+      double_value = is_uint ? (double)uint_value : (double)int_value;
+    }
+    return RCLPY_FILTER_COMPARE(double_value, filter->operand_double, filter->op);
+  }
+  // Compare signed and unsigned values without converting one to the other
+  int cmp;
+  if (is_uint) {
+    if (filter->operand_is_large) {
+      cmp = RCLPY_FILTER_THREE_WAY(uint_value, filter->operand_uint);
+    } else if (filter->operand_int < 0) {
+      cmp = 1;
+    } else {
+      cmp = RCLPY_FILTER_THREE_WAY(uint_value, (uint64_t)filter->operand_int);
+    }
+  } else if (filter->operand_is_large) {
+    cmp = -1;
+  } else {
+    cmp = RCLPY_FILTER_THREE_WAY(int_value, filter->operand_int);
+  }
+  return RCLPY_FILTER_COMPARE(cmp, 0, filter->op);
+}
+
+#define RCLPY_LATENCY_NUM_BUCKETS 32
+
+/// Histogram of the receive time minus the source time stamp of messages taken by a subscription
+typedef struct
+{
+  /// Byte offsets of the sec and nanosec fields of the builtin_interfaces/Time stamp
+  size_t sec_offset;
+  size_t nanosec_offset;
+  /// Number of messages recorded in the histogram
+  uint64_t count;
+  /// Messages stamped in the future, e.g. because of clock skew between hosts
+  uint64_t negative_count;
+  /// Messages with a zero stamp, which were probably never stamped by the publisher
+  uint64_t unstamped_count;
+  int64_t min_ns;
+  int64_t max_ns;
+  int64_t sum_ns;
+  /// buckets[0] counts latencies below 1 us, buckets[i] latencies in [2^(i-1), 2^i) us
+  /// and the last bucket everything above
+  uint64_t buckets[RCLPY_LATENCY_NUM_BUCKETS];
+} rclpy_latency_tracker_t;
+
+/// Destructor for a latency tracker
+void
+_rclpy_destroy_latency_tracker(PyObject * pycapsule)
+{
+  rclpy_latency_tracker_t * tracker = (rclpy_latency_tracker_t *)PyCapsule_GetPointer(
+    pycapsule, "rclpy_latency_tracker_t");
+  if (!tracker) {
+    PyErr_Clear();
+    return;
+  }
+  PyMem_Free(tracker);
+}
+
+static void
+_latency_tracker_clear(rclpy_latency_tracker_t * tracker)
+{
+  tracker->count = 0;
+  tracker->negative_count = 0;
+  tracker->unstamped_count = 0;
+  tracker->min_ns = INT64_MAX;
+  tracker->max_ns = 0;
+  tracker->sum_ns = 0;
+  memset(tracker->buckets, 0, sizeof(tracker->buckets));
+}
+
+/// Create a latency tracker for a subscription
+/**
+ * The stamp field is resolved against the introspection type support of the message type once,
+ * so recording a taken message only reads two integers at known offsets.
+ *
+ * Raises ValueError if the stamp field does not exist or is not a builtin_interfaces/Time
+ * Raises RuntimeError if the message has no introspection type support
+ *
+ * \param[in] pymsg_type Message type associated with the subscription
+ * \param[in] pystamp_field_names sequence of field names from the message to the stamp
+ * \return Capsule pointing to the created rclpy_latency_tracker_t, or
+ * \return NULL on failure
+ */
+static PyObject *
+rclpy_create_latency_tracker(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pymsg_type;
+  PyObject * pystamp_field_names;
+
+  if (!PyArg_ParseTuple(args, "OO", &pymsg_type, &pystamp_field_names)) {
+    return NULL;
+  }
+
+  PyObject * pymetaclass = PyObject_GetAttrString(pymsg_type, "__class__");
+  if (!pymetaclass) {
+    return NULL;
+  }
+  const rosidl_message_type_support_t * ts = get_capsule_pointer(pymetaclass, "_TYPE_SUPPORT");
+  Py_DECREF(pymetaclass);
+  if (!ts) {
+    return NULL;
+  }
+
+  size_t stamp_offset;
+  const rosidl_typesupport_introspection_c__MessageMember * stamp =
+    _resolve_message_field(ts, pystamp_field_names, &stamp_offset);
+  if (!stamp) {
+    return NULL;
+  }
+  if (rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE != stamp->type_id_ ||
+    stamp->is_array_)
+  {
+    PyErr_Format(PyExc_ValueError,
+      "Field '%s' is not a builtin_interfaces/Time", stamp->name_);
+    return NULL;
+  }
+  const rosidl_typesupport_introspection_c__MessageMember * sec =
+    _get_message_member(stamp->members_, "sec");
+  if (!sec) {
+    return NULL;
+  }
+  const rosidl_typesupport_introspection_c__MessageMember * nanosec =
+    _get_message_member(stamp->members_, "nanosec");
+  if (!nanosec) {
+    return NULL;
+  }
+  if (rosidl_typesupport_introspection_c__ROS_TYPE_INT32 != sec->type_id_ ||
+    rosidl_typesupport_introspection_c__ROS_TYPE_UINT32 != nanosec->type_id_)
+  {
+    PyErr_Format(PyExc_ValueError,
+      "Field '%s' is not a builtin_interfaces/Time", stamp->name_);
+    return NULL;
+  }
+
+  rclpy_latency_tracker_t * tracker =
+    (rclpy_latency_tracker_t *)PyMem_Malloc(sizeof(rclpy_latency_tracker_t));
+  if (!tracker) {
+    return PyErr_NoMemory();
+  }
+  tracker->sec_offset = stamp_offset + sec->offset_;
+  tracker->nanosec_offset = stamp_offset + nanosec->offset_;
+  _latency_tracker_clear(tracker);
+
+  return PyCapsule_New(tracker, "rclpy_latency_tracker_t", _rclpy_destroy_latency_tracker);
+}
+
+/// Record the latency of a taken C message
+/**
+ * \param[in] tracker the tracker to update
+ * \param[in] ros_message the C message to inspect
+ * \param[in] now system time at which the message was taken
+ */
+static void
+_latency_tracker_record(
+  rclpy_latency_tracker_t * tracker, const void * ros_message, rcutils_time_point_value_t now)
+{
+  int32_t sec = *(const int32_t *)((const char *)ros_message + tracker->sec_offset);
+  uint32_t nanosec = *(const uint32_t *)((const char *)ros_message + tracker->nanosec_offset);
+  if (0 == sec && 0 == nanosec) {
+    tracker->unstamped_count++;
+    return;
+  }
+  int64_t latency_ns = now - ((int64_t)sec * 1000000000LL + nanosec);
+  if (latency_ns < 0) {
+    tracker->negative_count++;
+    return;
+  }
+
+  tracker->count++;
+  tracker->sum_ns += latency_ns;
+  if (latency_ns < tracker->min_ns) {
+    tracker->min_ns = latency_ns;
+  }
+  if (latency_ns > tracker->max_ns) {
+    tracker->max_ns = latency_ns;
+  }
+  int64_t latency_us = latency_ns / 1000;
+  size_t bucket = 0;
+  while (latency_us > 0 && bucket < RCLPY_LATENCY_NUM_BUCKETS - 1) {
+    latency_us >>= 1;
+    bucket++;
+  }
+  tracker->buckets[bucket]++;
+}
+
+/// Get the statistics recorded by a latency tracker
+/**
+ * Raises ValueError if pytracker is not a latency tracker capsule
+ *
+ * \param[in] pytracker Capsule pointing to the latency tracker
+ * \return dict with the keys 'count', 'negative_count', 'unstamped_count', 'min_ns', 'max_ns',
+ *   'mean_ns' and 'buckets', a list of (upper bound in nanoseconds, count) tuples where the upper
+ *   bound of the last bucket is None; 'min_ns', 'max_ns' and 'mean_ns' are None if 'count' is 0
+ */
+static PyObject *
+rclpy_latency_tracker_get_stats(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pytracker;
+
+  if (!PyArg_ParseTuple(args, "O", &pytracker)) {
+    return NULL;
+  }
+
+  rclpy_latency_tracker_t * tracker = (rclpy_latency_tracker_t *)PyCapsule_GetPointer(
+    pytracker, "rclpy_latency_tracker_t");
+  if (!tracker) {
+    return NULL;
+  }
+
+  PyObject * pybuckets = PyList_New(RCLPY_LATENCY_NUM_BUCKETS);
+  if (!pybuckets) {
+    return NULL;
+  }
+  for (size_t i = 0; i < RCLPY_LATENCY_NUM_BUCKETS; ++i) {
+    PyObject * pybucket;
+    if (i < RCLPY_LATENCY_NUM_BUCKETS - 1) {
+      pybucket = Py_BuildValue("(LK)", (1LL << i) * 1000LL, tracker->buckets[i]);
+    } else {
+      pybucket = Py_BuildValue("(OK)", Py_None, tracker->buckets[i]);
+    }
+    if (!pybucket) {
+      Py_DECREF(pybuckets);
+      return NULL;
+    }
+    PyList_SET_ITEM(pybuckets, i, pybucket);
+  }
+
+  if (0 == tracker->count) {
+    return Py_BuildValue(
+      "{sKsKsKsOsOsOsN}",
+      "count", tracker->count,
+      "negative_count", tracker->negative_count,
+      "unstamped_count", tracker->unstamped_count,
+      "min_ns", Py_None,
+      "max_ns", Py_None,
+      "mean_ns", Py_None,
+      "buckets", pybuckets);
+  }
+  return Py_BuildValue(
+    "{sKsKsKsLsLsdsN}",
+    "count", tracker->count,
+    "negative_count", tracker->negative_count,
+    "unstamped_count", tracker->unstamped_count,
+    "min_ns", tracker->min_ns,
+    "max_ns", tracker->max_ns,
+    "mean_ns", (double)tracker->sum_ns / (double)tracker->count,
+    "buckets", pybuckets);
+}
+
+/// Clear the statistics recorded by a latency tracker
+/**
+ * Raises ValueError if pytracker is not a latency tracker capsule
+ *
+ * \param[in] pytracker Capsule pointing to the latency tracker
+ * \return None
+ */
+static PyObject *
+rclpy_latency_tracker_reset(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pytracker;
+
+  if (!PyArg_ParseTuple(args, "O", &pytracker)) {
+    return NULL;
+  }
+
+  rclpy_latency_tracker_t * tracker = (rclpy_latency_tracker_t *)PyCapsule_GetPointer(
+    pytracker, "rclpy_latency_tracker_t");
+  if (!tracker) {
+    return NULL;
+  }
+  _latency_tracker_clear(tracker);
+  Py_RETURN_NONE;
+}
+
+/// Create a client
+/**
+ * This function will create a client for the given service name.
+ * This client will use the typesupport defined in the service module
+ * provided as pysrv_type to send messages over the wire.
+ *
+ * On a successful call a list with two elements is returned:
+ *
+ * - a Capsule pointing to the pointer of the created rcl_client_t * structure
+ * - an integer representing the memory address of the created rcl_client_t
+ *
+ * Raises ValueError if the capsules are not the correct types
+ * Raises RuntimeError if the client could not be created
+ *
+ * \param[in] pynode Capsule pointing to the node to add the client to
+ * \param[in] pysrv_type Service module associated with the client
  * \param[in] pyservice_name Python object containing the service name
  * \param[in] pyqos_profile QoSProfile Python object for this client
  * \return capsule and memory address, or
@@ -1878,6 +3011,155 @@ rclpy_send_request(PyObject * Py_UNUSED(self), PyObject * args)
   return PyLong_FromLongLong(sequence_number);
 }
 
+/// Publish a batch of request messages
+/**
+ * All requests are converted first, then sent one after the other with the GIL released.
+ * If a conversion fails nothing is sent.
+ * If a send fails the following requests are not sent, and the error is returned with the
+ * sequence numbers of the requests sent before it so their responses can still be matched.
+ *
+ * Raises ValueError if pyclient is not a client capsule
+ * Raises TypeError if the requests are not all instances of the same type
+ *
+ * \param[in] pyclient Capsule pointing to the client
+ * \param[in] pyrequests sequence of request messages to send
+ * \return 2-tuple of the list of the sequence numbers of the sent requests, in order, and None
+ *   if all were sent, else the message of the error which stopped sending
+ */
+static PyObject *
+rclpy_send_requests(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pyclient;
+  PyObject * pyrequests;
+
+  if (!PyArg_ParseTuple(args, "OO", &pyclient, &pyrequests)) {
+    return NULL;
+  }
+  rcl_client_t * client = (rcl_client_t *)PyCapsule_GetPointer(pyclient, "rcl_client_t");
+  if (!client) {
+    return NULL;
+  }
+
+  PyObject * pyrequests_seq = PySequence_Fast(pyrequests, "requests must be a sequence");
+  if (!pyrequests_seq) {
+    return NULL;
+  }
+  Py_ssize_t num_requests = PySequence_Fast_GET_SIZE(pyrequests_seq);
+  if (0 == num_requests) {
+    Py_DECREF(pyrequests_seq);
+    return Py_BuildValue("(NO)", PyList_New(0), Py_None);
+  }
+  PyObject ** items = PySequence_Fast_ITEMS(pyrequests_seq);
+
+  // All requests share the type of the first one, so the type support is looked up once
+  PyTypeObject * request_type = Py_TYPE(items[0]);
+  PyObject * pymetaclass = PyObject_GetAttrString((PyObject *)request_type, "__class__");
+  assert(pymetaclass != NULL);
+
+  create_ros_message_signature * create_ros_message = get_capsule_pointer(
+    pymetaclass, "_CREATE_ROS_MESSAGE");
+  assert(create_ros_message != NULL &&
+    "unable to retrieve create_ros_message function, type_support mustn't have been imported");
+
+  destroy_ros_message_signature * destroy_ros_message = get_capsule_pointer(
+    pymetaclass, "_DESTROY_ROS_MESSAGE");
+  assert(destroy_ros_message != NULL &&
+    "unable to retrieve destroy_ros_message function, type_support mustn't have been imported");
+
+  convert_from_py_signature * convert_from_py = get_capsule_pointer(
+    pymetaclass, "_CONVERT_FROM_PY");
+  assert(convert_from_py != NULL &&
+    "unable to retrieve convert_from_py function, type_support mustn't have been imported");
+
+  Py_DECREF(pymetaclass);
+
+  void ** raw_ros_requests = (void **)PyMem_Calloc(num_requests, sizeof(void *));
+  int64_t * sequence_numbers = (int64_t *)PyMem_Malloc(num_requests * sizeof(int64_t));
+  if (!raw_ros_requests || !sequence_numbers) {
+    PyMem_Free(raw_ros_requests);
+    PyMem_Free(sequence_numbers);
+    Py_DECREF(pyrequests_seq);
+    return PyErr_NoMemory();
+  }
+
+  Py_ssize_t num_converted = 0;
+  for (; num_converted < num_requests; ++num_converted) {
+    PyObject * pyrequest = items[num_converted];
+    if (Py_TYPE(pyrequest) != request_type) {
+      PyErr_Format(PyExc_TypeError,
+        "All requests must be of type '%s', got '%s' at index %zd",
+        request_type->tp_name, Py_TYPE(pyrequest)->tp_name, num_converted);
+      break;
+    }
+    raw_ros_requests[num_converted] = create_ros_message();
+    if (!raw_ros_requests[num_converted]) {
+      PyErr_NoMemory();
+      break;
+    }
+    if (!convert_from_py(pyrequest, raw_ros_requests[num_converted])) {
+      // the function has set the Python error
+      destroy_ros_message(raw_ros_requests[num_converted]);
+      break;
+    }
+  }
+  Py_DECREF(pyrequests_seq);
+
+  Py_ssize_t num_sent = 0;
+  rcl_ret_t ret = RCL_RET_OK;
+  if (num_converted == num_requests) {
+    Py_BEGIN_ALLOW_THREADS;
+    for (; num_sent < num_requests; ++num_sent) {
+      ret = rcl_send_request(client, raw_ros_requests[num_sent], &sequence_numbers[num_sent]);
+      if (ret != RCL_RET_OK) {
+        break;
+      }
+    }
+    Py_END_ALLOW_THREADS;
+  }
+
+  for (Py_ssize_t i = 0; i < num_converted; ++i) {
+    destroy_ros_message(raw_ros_requests[i]);
+  }
+  PyMem_Free(raw_ros_requests);
+
+  if (num_converted != num_requests) {
+    PyMem_Free(sequence_numbers);
+    return NULL;
+  }
+  PyObject * pyerror = Py_None;
+  Py_INCREF(pyerror);
+  if (ret != RCL_RET_OK) {
+    Py_DECREF(pyerror);
+    pyerror = PyUnicode_FromFormat(
+      "Failed to send request %zd of %zd: %s", num_sent, num_requests,
+      rcl_get_error_string().str);
+    rcl_reset_error();
+    if (!pyerror) {
+      PyMem_Free(sequence_numbers);
+      return NULL;
+    }
+  }
+
+  PyObject * pysequence_numbers = PyList_New(num_sent);
+  if (!pysequence_numbers) {
+    Py_DECREF(pyerror);
+    PyMem_Free(sequence_numbers);
+    return NULL;
+  }
+  for (Py_ssize_t i = 0; i < num_sent; ++i) {
+    PyObject * pysequence_number = PyLong_FromLongLong(sequence_numbers[i]);
+    if (!pysequence_number) {
+      Py_DECREF(pyerror);
+      Py_DECREF(pysequence_numbers);
+      PyMem_Free(sequence_numbers);
+      return NULL;
+    }
+    PyList_SET_ITEM(pysequence_numbers, i, pysequence_number);
+  }
+  PyMem_Free(sequence_numbers);
+  return Py_BuildValue("(NN)", pysequence_numbers, pyerror);
+}
+
 /// Create a service server
 /**
  * This function will create a service server for the given service name.
@@ -1964,6 +3246,56 @@ rclpy_create_service(PyObject * Py_UNUSED(self), PyObject * args)
   return pylist;
 }
 
+#define RCLPY_REQUEST_HEADER_POOL_SIZE 64
+
+/// Free list of request headers handed out by rclpy_take_request, protected by the GIL
+static rmw_request_id_t * g_request_header_pool[RCLPY_REQUEST_HEADER_POOL_SIZE];
+static size_t g_request_header_pool_count = 0;
+
+/// Get a request header from the free list, or allocate one if it is empty
+/**
+ * Must be called with the GIL held.
+ *
+ * \return a header, or NULL if allocation failed
+ */
+static rmw_request_id_t *
+_request_header_alloc(void)
+{
+  if (g_request_header_pool_count > 0) {
+    return g_request_header_pool[--g_request_header_pool_count];
+  }
+  return (rmw_request_id_t *)PyMem_Malloc(sizeof(rmw_request_id_t));
+}
+
+/// Return a request header to the free list, or free it if the list is full
+/**
+ * Must be called with the GIL held.
+ *
+ * \param[in] header the header to release
+ */
+static void
+_request_header_release(rmw_request_id_t * header)
+{
+  if (g_request_header_pool_count < RCLPY_REQUEST_HEADER_POOL_SIZE) {
+    g_request_header_pool[g_request_header_pool_count++] = header;
+  } else {
+    PyMem_Free(header);
+  }
+}
+
+static void
+_request_header_capsule_destructor(PyObject * pycapsule)
+{
+  rmw_request_id_t * header =
+    (rmw_request_id_t *)PyCapsule_GetPointer(pycapsule, "rmw_request_id_t");
+  if (!header) {
+    // A NULL header in the free list would look like an allocation failure
+    PyErr_Clear();
+    return;
+  }
+  _request_header_release(header);
+}
+
 /// Publish a response message
 /**
  * Raises ValueError if the capsules are not the correct types
@@ -2072,17 +3404,52 @@ rclpy_service_server_is_available(PyObject * Py_UNUSED(self), PyObject * args)
   bool is_ready;
   rcl_ret_t ret = rcl_service_server_is_available(node, client, &is_ready);
 
-  if (ret != RCL_RET_OK) {
+  if (ret != RCL_RET_OK) {
+    PyErr_Format(PyExc_RuntimeError,
+      "Failed to check service availability: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+    return NULL;
+  }
+
+  if (is_ready) {
+    Py_RETURN_TRUE;
+  }
+  Py_RETURN_FALSE;
+}
+
+/// Get the guard condition of a node triggered when the ROS graph changes
+/**
+ * The guard condition is owned by the node: it must not be destroyed and must not be used after
+ * the node is.
+ *
+ * Raises ValueError if pynode is not a node capsule
+ * Raises RuntimeError if the node is invalid
+ *
+ * \param[in] pynode Capsule pointing to the node
+ * \return Capsule pointing to the graph guard condition
+ */
+static PyObject *
+rclpy_get_graph_guard_condition(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pynode;
+
+  if (!PyArg_ParseTuple(args, "O", &pynode)) {
+    return NULL;
+  }
+
+  rcl_node_t * node = (rcl_node_t *)PyCapsule_GetPointer(pynode, "rcl_node_t");
+  if (!node) {
+    return NULL;
+  }
+
+  const rcl_guard_condition_t * graph_gc = rcl_node_get_graph_guard_condition(node);
+  if (!graph_gc) {
     PyErr_Format(PyExc_RuntimeError,
-      "Failed to check service availability: %s", rcl_get_error_string().str);
+      "Failed to get graph guard condition: %s", rcl_get_error_string().str);
     rcl_reset_error();
     return NULL;
   }
-
-  if (is_ready) {
-    Py_RETURN_TRUE;
-  }
-  Py_RETURN_FALSE;
+  return PyCapsule_New((void *)graph_gc, "rcl_guard_condition_t", NULL);
 }
 
 /// Destroy an entity attached to a node
@@ -2603,17 +3970,39 @@ rclpy_wait(PyObject * Py_UNUSED(self), PyObject * args)
 
 /// Take a message from a given subscription
 /**
+ * If a content filter is given, messages it rejects are dropped before being converted to
+ * Python and None is returned as if nothing was taken.
+ *
+ * If keep_latest is true, all pending messages are taken and only the newest one (that passes
+ * the content filter) is converted to Python. Older messages are dropped.
+ *
+ * If a latency tracker is given, every taken message is recorded in it, including the ones
+ * dropped by the content filter or keep_latest.
+ *
  * \param[in] pysubscription Capsule pointing to the subscription to process the message
  * \param[in] pymsg_type Instance of the message type to take
- * \return Python message with all fields populated with received message
+ * \param[in] pycontent_filter Capsule pointing to a content filter, or None
+ * \param[in] keep_latest True to drain the subscription and return only the newest message
+ * \param[in] pylatency_tracker Capsule pointing to a latency tracker, or None
+ * \param[in] with_message_info True to also return the message info of the returned message
+ * \return Python message with all fields populated with received message, or
+ * \return tuple of the Python message and a (publisher gid bytes, from intra process) tuple
+ *   if with_message_info is true
  */
 static PyObject *
 rclpy_take(PyObject * Py_UNUSED(self), PyObject * args)
 {
   PyObject * pysubscription;
   PyObject * pymsg_type;
+  PyObject * pycontent_filter = Py_None;
+  int keep_latest = 0;
+  PyObject * pylatency_tracker = Py_None;
+  int with_message_info = 0;
 
-  if (!PyArg_ParseTuple(args, "OO", &pysubscription, &pymsg_type)) {
+  if (!PyArg_ParseTuple(
+      args, "OO|OpOp", &pysubscription, &pymsg_type, &pycontent_filter, &keep_latest,
+      &pylatency_tracker, &with_message_info))
+  {
     return NULL;
   }
   if (!PyCapsule_CheckExact(pysubscription)) {
@@ -2623,6 +4012,24 @@ rclpy_take(PyObject * Py_UNUSED(self), PyObject * args)
   rcl_subscription_t * subscription =
     (rcl_subscription_t *)PyCapsule_GetPointer(pysubscription, "rcl_subscription_t");
 
+  rclpy_content_filter_t * content_filter = NULL;
+  if (Py_None != pycontent_filter) {
+    content_filter = (rclpy_content_filter_t *)PyCapsule_GetPointer(
+      pycontent_filter, "rclpy_content_filter_t");
+    if (!content_filter) {
+      return NULL;
+    }
+  }
+
+  rclpy_latency_tracker_t * latency_tracker = NULL;
+  if (Py_None != pylatency_tracker) {
+    latency_tracker = (rclpy_latency_tracker_t *)PyCapsule_GetPointer(
+      pylatency_tracker, "rclpy_latency_tracker_t");
+    if (!latency_tracker) {
+      return NULL;
+    }
+  }
+
   PyObject * pymetaclass = PyObject_GetAttrString(pymsg_type, "__class__");
 
   create_ros_message_signature * create_ros_message = get_capsule_pointer(
@@ -2635,39 +4042,88 @@ rclpy_take(PyObject * Py_UNUSED(self), PyObject * args)
   assert(destroy_ros_message != NULL &&
     "unable to retrieve destroy_ros_message function, type_support mustn't have been imported");
 
-  void * taken_msg = create_ros_message();
-  if (!taken_msg) {
-    Py_DECREF(pymetaclass);
-    return PyErr_NoMemory();
-  }
+  // The newest message that passed the filter, and scratch space for the next take
+  void * latest_msg = NULL;
+  void * taken_msg = NULL;
+  rmw_message_info_t latest_info;
+  rmw_message_info_t taken_info;
+
+  rcl_ret_t ret;
+  do {
+    if (!taken_msg) {
+      taken_msg = create_ros_message();
+      if (!taken_msg) {
+        if (latest_msg) {
+          destroy_ros_message(latest_msg);
+        }
+        Py_DECREF(pymetaclass);
+        return PyErr_NoMemory();
+      }
+    }
 
-  rcl_ret_t ret = rcl_take(subscription, taken_msg, NULL);
+    ret = rcl_take(subscription, taken_msg, &taken_info);
 
-  if (ret != RCL_RET_OK && ret != RCL_RET_SUBSCRIPTION_TAKE_FAILED) {
-    PyErr_Format(PyExc_RuntimeError,
-      "Failed to take from a subscription: %s", rcl_get_error_string().str);
-    rcl_reset_error();
+    if (ret != RCL_RET_OK && ret != RCL_RET_SUBSCRIPTION_TAKE_FAILED) {
+      PyErr_Format(PyExc_RuntimeError,
+        "Failed to take from a subscription: %s", rcl_get_error_string().str);
+      rcl_reset_error();
+      destroy_ros_message(taken_msg);
+      if (latest_msg) {
+        destroy_ros_message(latest_msg);
+      }
+      Py_DECREF(pymetaclass);
+      return NULL;
+    }
+
+    if (ret == RCL_RET_SUBSCRIPTION_TAKE_FAILED) {
+      break;
+    }
+
+    if (latency_tracker) {
+      rcutils_time_point_value_t now;
+      if (RCUTILS_RET_OK == rcutils_system_time_now(&now)) {
+        _latency_tracker_record(latency_tracker, taken_msg, now);
+      }
+    }
+
+    if (!content_filter || _content_filter_matches(content_filter, taken_msg)) {
+      // Reuse the older message as scratch space for the next take
+      void * older_msg = latest_msg;
+      latest_msg = taken_msg;
+      taken_msg = older_msg;
+      latest_info = taken_info;
+    }
+  } while (keep_latest && ret == RCL_RET_OK);
+  if (taken_msg) {
     destroy_ros_message(taken_msg);
-    Py_DECREF(pymetaclass);
-    return NULL;
   }
 
-  if (ret != RCL_RET_SUBSCRIPTION_TAKE_FAILED) {
+  if (latest_msg) {
     convert_to_py_signature * convert_to_py = get_capsule_pointer(pymetaclass, "_CONVERT_TO_PY");
     Py_DECREF(pymetaclass);
 
-    PyObject * pytaken_msg = convert_to_py(taken_msg);
-    destroy_ros_message(taken_msg);
+    PyObject * pytaken_msg = convert_to_py(latest_msg);
+    destroy_ros_message(latest_msg);
     if (!pytaken_msg) {
       // the function has set the Python error
       return NULL;
     }
 
+    if (with_message_info) {
+      PyObject * pypublisher_gid = PyBytes_FromStringAndSize(
+        (const char *)latest_info.publisher_gid.data, RMW_GID_STORAGE_SIZE);
+      if (!pypublisher_gid) {
+        Py_DECREF(pytaken_msg);
+        return NULL;
+      }
+      return Py_BuildValue(
+        "(N(NO))", pytaken_msg, pypublisher_gid,
+        latest_info.from_intra_process ? Py_True : Py_False);
+    }
     return pytaken_msg;
   }
 
-  // if take failed, just do nothing
-  destroy_ros_message(taken_msg);
+  // if take failed or the message was filtered out, just do nothing
   Py_DECREF(pymetaclass);
   Py_RETURN_NONE;
 }
@@ -2680,7 +4136,8 @@ rclpy_take(PyObject * Py_UNUSED(self), PyObject * args)
  * \param[in] pyrequest_type Instance of the message type to take
  * \return List with 2 elements:
  *            first element: a Python request message with all fields populated with received request
- *            second element: a Capsule pointing to the header (rmw_request_id) of the processed request
+ *            second element: a Capsule pointing to the header (rmw_request_id) of the processed request;
+ *            the header goes back to a free list when the capsule is released
  */
 static PyObject *
 rclpy_take_request(PyObject * Py_UNUSED(self), PyObject * args)
@@ -2717,7 +4174,12 @@ rclpy_take_request(PyObject * Py_UNUSED(self), PyObject * args)
     return PyErr_NoMemory();
   }
 
-  rmw_request_id_t * header = (rmw_request_id_t *)PyMem_Malloc(sizeof(rmw_request_id_t));
+  rmw_request_id_t * header = _request_header_alloc();
+  if (!header) {
+    destroy_ros_message(taken_request);
+    Py_DECREF(pymetaclass);
+    return PyErr_NoMemory();
+  }
   rcl_ret_t ret = rcl_take_request(service, header, taken_request);
 
   if (ret != RCL_RET_OK && ret != RCL_RET_SERVICE_TAKE_FAILED) {
@@ -2725,7 +4187,7 @@ rclpy_take_request(PyObject * Py_UNUSED(self), PyObject * args)
       "Service failed to take request: %s", rcl_get_error_string().str);
     rcl_reset_error();
     destroy_ros_message(taken_request);
-    PyMem_Free(header);
+    _request_header_release(header);
     Py_DECREF(pymetaclass);
     return NULL;
   }
@@ -2738,18 +4200,30 @@ rclpy_take_request(PyObject * Py_UNUSED(self), PyObject * args)
     destroy_ros_message(taken_request);
     if (!pytaken_request) {
       // the function has set the Python error
-      PyMem_Free(header);
+      _request_header_release(header);
       return NULL;
     }
 
+    PyObject * pyheader = PyCapsule_New(
+      header, "rmw_request_id_t", _request_header_capsule_destructor);
+    if (!pyheader) {
+      _request_header_release(header);
+      Py_DECREF(pytaken_request);
+      return NULL;
+    }
     PyObject * pylist = PyList_New(2);
+    if (!pylist) {
+      Py_DECREF(pyheader);
+      Py_DECREF(pytaken_request);
+      return NULL;
+    }
     PyList_SET_ITEM(pylist, 0, pytaken_request);
-    PyList_SET_ITEM(pylist, 1, PyCapsule_New(header, "rmw_request_id_t", NULL));
+    PyList_SET_ITEM(pylist, 1, pyheader);
 
     return pylist;
   }
   // if take_request failed, just do nothing
-  PyMem_Free(header);
+  _request_header_release(header);
   destroy_ros_message(taken_request);
   Py_DECREF(pymetaclass);
   Py_RETURN_NONE;
@@ -2796,10 +4270,9 @@ rclpy_take_response(PyObject * Py_UNUSED(self), PyObject * args)
     Py_DECREF(pymetaclass);
     return NULL;
   }
-  rmw_request_id_t * header = (rmw_request_id_t *)PyMem_Malloc(sizeof(rmw_request_id_t));
-  rcl_ret_t ret = rcl_take_response(client, header, taken_response);
-  int64_t sequence = header->sequence_number;
-  PyMem_Free(header);
+  rmw_request_id_t header;
+  rcl_ret_t ret = rcl_take_response(client, &header, taken_response);
+  int64_t sequence = header.sequence_number;
 
   // Create the tuple to return
   PyObject * pytuple = PyTuple_New(2);
@@ -2838,6 +4311,125 @@ rclpy_take_response(PyObject * Py_UNUSED(self), PyObject * args)
   return pytuple;
 }
 
+/// Wait for a response to a client and take it
+/**
+ * Waits on pywait_set, which must have room for one client and one guard condition, until the
+ * client has a response or the guard condition is triggered.
+ * Waiting and taking are done without the GIL, which is only taken to convert the response.
+ *
+ * Raises ValueError if the arguments are not the right capsules
+ * Raises RuntimeError if waiting or taking fails
+ *
+ * \param[in] pyclient Capsule pointing to the client to process the response
+ * \param[in] pyresponse_type Instance of the message type to take
+ * \param[in] pywait_set Capsule pointing to the wait set to use
+ * \param[in] pyguard_condition Capsule pointing to a guard condition interrupting the wait
+ * \param[in] timeout nanoseconds to wait, wait forever if negative
+ * \return 2-tuple sequence number and received response, or
+ * \return None if the wait timed out, was interrupted or the response was taken by another thread
+ */
+static PyObject *
+rclpy_wait_and_take_response(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pyclient;
+  PyObject * pyresponse_type;
+  PyObject * pywait_set;
+  PyObject * pyguard_condition;
+  PY_LONG_LONG timeout;
+
+  if (!PyArg_ParseTuple(
+      args, "OOOOL", &pyclient, &pyresponse_type, &pywait_set, &pyguard_condition, &timeout))
+  {
+    return NULL;
+  }
+  rcl_client_t * client = (rcl_client_t *)PyCapsule_GetPointer(pyclient, "rcl_client_t");
+  if (!client) {
+    return NULL;
+  }
+  rcl_wait_set_t * wait_set = (rcl_wait_set_t *)PyCapsule_GetPointer(pywait_set, "rcl_wait_set_t");
+  if (!wait_set) {
+    return NULL;
+  }
+  rcl_guard_condition_t * guard_condition = (rcl_guard_condition_t *)PyCapsule_GetPointer(
+    pyguard_condition, "rcl_guard_condition_t");
+  if (!guard_condition) {
+    return NULL;
+  }
+
+  size_t index;
+  rcl_ret_t ret = rcl_wait_set_clear(wait_set);
+  if (ret == RCL_RET_OK) {
+    ret = rcl_wait_set_add_client(wait_set, client, &index);
+  }
+  if (ret == RCL_RET_OK) {
+    ret = rcl_wait_set_add_guard_condition(wait_set, guard_condition, &index);
+  }
+  if (ret != RCL_RET_OK) {
+    PyErr_Format(PyExc_RuntimeError,
+      "Failed to prepare wait set: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+    return NULL;
+  }
+
+  PyObject * pymetaclass = PyObject_GetAttrString(pyresponse_type, "__class__");
+
+  create_ros_message_signature * create_ros_message = get_capsule_pointer(
+    pymetaclass, "_CREATE_ROS_MESSAGE");
+  assert(create_ros_message != NULL &&
+    "unable to retrieve create_ros_message function, type_support mustn't have been imported");
+
+  destroy_ros_message_signature * destroy_ros_message = get_capsule_pointer(
+    pymetaclass, "_DESTROY_ROS_MESSAGE");
+  assert(destroy_ros_message != NULL &&
+    "unable to retrieve destroy_ros_message function, type_support mustn't have been imported");
+
+  convert_to_py_signature * convert_to_py = get_capsule_pointer(pymetaclass, "_CONVERT_TO_PY");
+  assert(convert_to_py != NULL &&
+    "unable to retrieve convert_to_py function, type_support mustn't have been imported");
+
+  Py_DECREF(pymetaclass);
+
+  void * taken_response = create_ros_message();
+  if (!taken_response) {
+    return PyErr_NoMemory();
+  }
+
+  rmw_request_id_t header;
+  bool taken = false;
+  Py_BEGIN_ALLOW_THREADS;
+  ret = rcl_wait(wait_set, timeout);
+  if (ret == RCL_RET_OK && wait_set->clients[0]) {
+    ret = rcl_take_response(client, &header, taken_response);
+    if (ret == RCL_RET_OK) {
+      taken = true;
+    } else if (ret == RCL_RET_CLIENT_TAKE_FAILED) {
+      // Another thread took the response first
+      ret = RCL_RET_OK;
+    }
+  }
+  Py_END_ALLOW_THREADS;
+
+  if (ret != RCL_RET_OK && ret != RCL_RET_TIMEOUT) {
+    PyErr_Format(PyExc_RuntimeError,
+      "Failed to wait for a response: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+    destroy_ros_message(taken_response);
+    return NULL;
+  }
+  if (!taken) {
+    destroy_ros_message(taken_response);
+    Py_RETURN_NONE;
+  }
+
+  PyObject * pytaken_response = convert_to_py(taken_response);
+  destroy_ros_message(taken_response);
+  if (!pytaken_response) {
+    // the function has set the Python error
+    return NULL;
+  }
+  return Py_BuildValue("(LN)", (PY_LONG_LONG)header.sequence_number, pytaken_response);
+}
+
 /// Status of the the client library
 /**
  * \return True if rcl is running properly, False otherwise
@@ -3219,147 +4811,409 @@ rclpy_get_rmw_qos_profile(PyObject * Py_UNUSED(self), PyObject * args)
   return pyqos_profile;
 }
 
-/// Destructor for a time point
-void
-_rclpy_destroy_time_point(PyObject * pycapsule)
+/// Time point with its nanoseconds and clock type stored inline
+/**
+ * Base type of rclpy.time.Time.
+ * Arithmetic and comparisons are implemented here so they never go through a Python call.
+ */
+typedef struct
+{
+  PyObject_HEAD
+  rcl_time_point_t time_point;
+  /// The rclpy.clock.ClockType of the time point, or NULL if it has not been initialized
+  PyObject * pyclock_type;
+} rclpy_time_point_t;
+
+/// Duration with its nanoseconds stored inline
+/**
+ * Base type of rclpy.duration.Duration.
+ */
+typedef struct
+{
+  PyObject_HEAD
+  rcl_duration_t duration;
+} rclpy_duration_t;
+
+static PyTypeObject rclpy_time_point_type;
+static PyTypeObject rclpy_duration_type;
+
+/// Name of the class attribute holding the type of the difference between two time points
+static PyObject * g_duration_type_attr;
+
+#define RCLPY_IS_TIME_POINT(op) PyObject_TypeCheck(op, &rclpy_time_point_type)
+#define RCLPY_IS_DURATION(op) PyObject_TypeCheck(op, &rclpy_duration_type)
+
+#define RCLPY_RICHCOMPARE(LHS, RHS, OP) \
+  do { \
+    bool result = false; \
+    switch (OP) { \
+      case Py_LT: result = (LHS) < (RHS); break; \
+      case Py_LE: result = (LHS) <= (RHS); break; \
+      case Py_EQ: result = (LHS) == (RHS); break; \
+      case Py_NE: result = (LHS) != (RHS); break; \
+      case Py_GT: result = (LHS) > (RHS); break; \
+      case Py_GE: result = (LHS) >= (RHS); break; \
+    } \
+    if (result) { \
+      Py_RETURN_TRUE; \
+    } \
+    Py_RETURN_FALSE; \
+  } while (0)
+
+/// Create a time point of the given type without calling its __init__
+/**
+ * \param[in] type rclpy_time_point_type or a subclass of it
+ * \param[in] nanoseconds value of the time point, interpreted as unsigned
+ * \param[in] clock_type rcl clock type of the time point
+ * \param[in] pyclock_type the ClockType enum matching clock_type, or NULL
+ * \return new reference to the time point, or NULL on failure
+ */
+static PyObject *
+_rclpy_time_point_create(
+  PyTypeObject * type, uint64_t nanoseconds, rcl_clock_type_t clock_type,
+  PyObject * pyclock_type)
 {
-  PyMem_Free(PyCapsule_GetPointer(pycapsule, "rcl_time_point_t"));
+  rclpy_time_point_t * time_point = (rclpy_time_point_t *)type->tp_alloc(type, 0);
+  if (!time_point) {
+    return NULL;
+  }
+  time_point->time_point.nanoseconds = (rcl_time_point_value_t)nanoseconds;
+  time_point->time_point.clock_type = clock_type;
+  Py_XINCREF(pyclock_type);
+  time_point->pyclock_type = pyclock_type;
+  return (PyObject *)time_point;
 }
 
-/// Create a time point
+/// Create a duration of the given type without calling its __init__
 /**
- * On failure, an exception is raised and NULL is returned if:
- *
- * Raises RuntimeError on initialization failure
- * Raises TypeError if argument of invalid type
- * Raises OverflowError if nanoseconds argument cannot be converted to uint64_t
+ * \param[in] type rclpy_duration_type or a subclass of it
+ * \param[in] nanoseconds value of the duration
+ * \return new reference to the duration, or NULL on failure
+ */
+static PyObject *
+_rclpy_duration_create(PyTypeObject * type, int64_t nanoseconds)
+{
+  rclpy_duration_t * duration = (rclpy_duration_t *)type->tp_alloc(type, 0);
+  if (!duration) {
+    return NULL;
+  }
+  duration->duration.nanoseconds = nanoseconds;
+  return (PyObject *)duration;
+}
+
+/// Initialize a time point
+/**
+ * Raises TypeError if an argument is not an integer
+ * Raises OverflowError if nanoseconds cannot be converted to uint64_t
  *
  * \param[in] nanoseconds unsigned PyLong object storing the nanoseconds value
  *   of the time point in a 64-bit unsigned integer
  * \param[in] clock_type enum of type ClockType
- * \return Capsule of the pointer to the created rcl_time_point_t * structure, or
- * \return NULL on failure
+ * \return 0 on success, -1 on failure
  */
-static PyObject *
-rclpy_create_time_point(PyObject * Py_UNUSED(self), PyObject * args)
+static int
+rclpy_time_point_init(PyObject * self, PyObject * args, PyObject * kwds)
 {
-  PyObject * pylong_nanoseconds;
-  unsigned PY_LONG_LONG clock_type;
+  static char * kwlist[] = {"nanoseconds", "clock_type", NULL};
+  PyObject * pynanoseconds;
+  PyObject * pyclock_type;
 
-  if (!PyArg_ParseTuple(args, "OK", &pylong_nanoseconds, &clock_type)) {
-    return NULL;
+  if (!PyArg_ParseTupleAndKeywords(
+      args, kwds, "OO:TimePoint", kwlist, &pynanoseconds, &pyclock_type))
+  {
+    return -1;
   }
 
-  unsigned PY_LONG_LONG nanoseconds = PyLong_AsUnsignedLongLong(pylong_nanoseconds);
+  unsigned PY_LONG_LONG nanoseconds = PyLong_AsUnsignedLongLong(pynanoseconds);
   if (PyErr_Occurred()) {
-    return NULL;
+    return -1;
   }
-
-  rcl_time_point_t * time_point = (rcl_time_point_t *) PyMem_Malloc(sizeof(rcl_time_point_t));
-  if (NULL == time_point) {
-    PyErr_Format(PyExc_RuntimeError, "Failed to allocate memory for time point.");
-    return NULL;
+  long clock_type = PyLong_AsLong(pyclock_type);
+  if (PyErr_Occurred()) {
+    return -1;
   }
 
-  time_point->nanoseconds = nanoseconds;
-  time_point->clock_type = clock_type;
+  rclpy_time_point_t * time_point = (rclpy_time_point_t *)self;
+  time_point->time_point.nanoseconds = (rcl_time_point_value_t)nanoseconds;
+  time_point->time_point.clock_type = (rcl_clock_type_t)clock_type;
+  PyObject * old_pyclock_type = time_point->pyclock_type;
+  Py_INCREF(pyclock_type);
+  time_point->pyclock_type = pyclock_type;
+  Py_XDECREF(old_pyclock_type);
+  return 0;
+}
+
+static void
+rclpy_time_point_dealloc(PyObject * self)
+{
+  Py_CLEAR(((rclpy_time_point_t *)self)->pyclock_type);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static PyObject *
+rclpy_time_point_get_nanoseconds(PyObject * self, void * Py_UNUSED(closure))
+{
+  return PyLong_FromUnsignedLongLong(
+    (uint64_t)((rclpy_time_point_t *)self)->time_point.nanoseconds);
+}
 
-  return PyCapsule_New(time_point, "rcl_time_point_t", _rclpy_destroy_time_point);
+static PyObject *
+rclpy_time_point_get_clock_type(PyObject * self, void * Py_UNUSED(closure))
+{
+  PyObject * pyclock_type = ((rclpy_time_point_t *)self)->pyclock_type;
+  if (!pyclock_type) {
+    Py_RETURN_NONE;
+  }
+  Py_INCREF(pyclock_type);
+  return pyclock_type;
 }
 
-/// Returns the nanoseconds value of the time point
+/// Compare two time points
 /**
- * On failure, an exception is raised and NULL is returned if:
- *
- * Raises ValueError if pytime_point is not a time point capsule
- *
- * \param[in] pytime_point Capsule pointing to the time point
- * \return NULL on failure:
- *         PyLong integer in nanoseconds on success
+ * Raises TypeError if the time points have different clock types
+ * Raises TypeError on == and != with anything but a time point, so that a mistake like
+ * `Time(nanoseconds=5) == 5` doesn't quietly evaluate to False
  */
 static PyObject *
-rclpy_time_point_get_nanoseconds(PyObject * Py_UNUSED(self), PyObject * args)
+rclpy_time_point_richcompare(PyObject * a, PyObject * b, int op)
 {
-  PyObject * pytime_point;
-  if (!PyArg_ParseTuple(args, "O", &pytime_point)) {
+  if (!RCLPY_IS_TIME_POINT(a) || !RCLPY_IS_TIME_POINT(b)) {
+    if (Py_EQ == op || Py_NE == op) {
+      PyObject * other = RCLPY_IS_TIME_POINT(a) ? b : a;
+      PyErr_Format(PyExc_TypeError,
+        "Can't compare time with object of type: %s", Py_TYPE(other)->tp_name);
+      return NULL;
+    }
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+  rcl_time_point_t * lhs = &((rclpy_time_point_t *)a)->time_point;
+  rcl_time_point_t * rhs = &((rclpy_time_point_t *)b)->time_point;
+  if (lhs->clock_type != rhs->clock_type) {
+    PyErr_Format(PyExc_TypeError, "Can't compare times with different clock types");
     return NULL;
   }
+  RCLPY_RICHCOMPARE((uint64_t)lhs->nanoseconds, (uint64_t)rhs->nanoseconds, op);
+}
 
-  rcl_time_point_t * time_point = (rcl_time_point_t *)PyCapsule_GetPointer(
-    pytime_point, "rcl_time_point_t");
-  if (!time_point) {
-    return NULL;
+/// Add a duration to a time point, in either order
+/**
+ * Raises OverflowError if the sum does not fit in a time point
+ * Raises ValueError if the sum is negative
+ *
+ * \return a time point of the same type as the time point operand
+ */
+static PyObject *
+rclpy_time_point_add(PyObject * a, PyObject * b)
+{
+  rclpy_time_point_t * time_point;
+  rclpy_duration_t * duration;
+  if (RCLPY_IS_TIME_POINT(a) && RCLPY_IS_DURATION(b)) {
+    time_point = (rclpy_time_point_t *)a;
+    duration = (rclpy_duration_t *)b;
+  } else if (RCLPY_IS_DURATION(a) && RCLPY_IS_TIME_POINT(b)) {
+    time_point = (rclpy_time_point_t *)b;
+    duration = (rclpy_duration_t *)a;
+  } else {
+    Py_RETURN_NOTIMPLEMENTED;
   }
 
-  return PyLong_FromUnsignedLongLong(time_point->nanoseconds);
+  uint64_t nanoseconds = (uint64_t)time_point->time_point.nanoseconds;
+  int64_t delta = duration->duration.nanoseconds;
+  if (delta >= 0) {
+    if (nanoseconds > UINT64_MAX - (uint64_t)delta) {
+      PyErr_Format(PyExc_OverflowError, "Addition leads to overflow in C storage.");
+      return NULL;
+    }
+    nanoseconds += (uint64_t)delta;
+  } else {
+    uint64_t magnitude = (uint64_t)(-(delta + 1)) + 1;
+    if (nanoseconds < magnitude) {
+      PyErr_Format(PyExc_ValueError, "Addition leads to negative time.");
+      return NULL;
+    }
+    nanoseconds -= magnitude;
+  }
+  return _rclpy_time_point_create(
+    Py_TYPE(time_point), nanoseconds, time_point->time_point.clock_type,
+    time_point->pyclock_type);
 }
 
-/// Destructor for a duration
-void
-_rclpy_destroy_duration(PyObject * pycapsule)
+/// Subtract a time point or a duration from a time point
+/**
+ * Raises TypeError if two time points have different clock types
+ * Raises OverflowError if the result does not fit in its storage
+ * Raises ValueError if subtracting a duration leads to a negative time
+ *
+ * \return the duration between two time points, as an instance of the `_duration_type`
+ *   attribute of the first one's type, or a time point of the same type as the first operand
+ */
+static PyObject *
+rclpy_time_point_subtract(PyObject * a, PyObject * b)
 {
-  PyMem_Free(PyCapsule_GetPointer(pycapsule, "rcl_duration_t"));
+  if (!RCLPY_IS_TIME_POINT(a)) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+  rclpy_time_point_t * time_point = (rclpy_time_point_t *)a;
+  uint64_t nanoseconds = (uint64_t)time_point->time_point.nanoseconds;
+
+  if (RCLPY_IS_TIME_POINT(b)) {
+    rclpy_time_point_t * other = (rclpy_time_point_t *)b;
+    if (time_point->time_point.clock_type != other->time_point.clock_type) {
+      PyErr_Format(PyExc_TypeError, "Can't subtract times with different clock types");
+      return NULL;
+    }
+    uint64_t other_nanoseconds = (uint64_t)other->time_point.nanoseconds;
+    int64_t difference;
+    if (nanoseconds >= other_nanoseconds) {
+      if (nanoseconds - other_nanoseconds > (uint64_t)INT64_MAX) {
+        PyErr_Format(PyExc_OverflowError, "Subtraction leads to overflow in C storage.");
+        return NULL;
+      }
+      difference = (int64_t)(nanoseconds - other_nanoseconds);
+    } else {
+      uint64_t magnitude = other_nanoseconds - nanoseconds;
+      if (magnitude > (uint64_t)INT64_MAX + 1) {
+        PyErr_Format(PyExc_OverflowError, "Subtraction leads to overflow in C storage.");
+        return NULL;
+      }
+      difference = -(int64_t)(magnitude - 1) - 1;
+    }
+
+    PyObject * pyduration_type = PyObject_GetAttr((PyObject *)Py_TYPE(a), g_duration_type_attr);
+    if (!pyduration_type) {
+      return NULL;
+    }
+    if (!PyType_Check(pyduration_type) ||
+      !PyType_IsSubtype((PyTypeObject *)pyduration_type, &rclpy_duration_type))
+    {
+      PyErr_Format(PyExc_TypeError, "_duration_type must be a subclass of Duration");
+      Py_DECREF(pyduration_type);
+      return NULL;
+    }
+    PyObject * pyduration = _rclpy_duration_create(
+      (PyTypeObject *)pyduration_type, difference);
+    Py_DECREF(pyduration_type);
+    return pyduration;
+  }
+
+  if (RCLPY_IS_DURATION(b)) {
+    int64_t delta = ((rclpy_duration_t *)b)->duration.nanoseconds;
+    if (delta >= 0) {
+      if (nanoseconds < (uint64_t)delta) {
+        PyErr_Format(PyExc_ValueError, "Subtraction leads to negative time.");
+        return NULL;
+      }
+      nanoseconds -= (uint64_t)delta;
+    } else {
+      uint64_t magnitude = (uint64_t)(-(delta + 1)) + 1;
+      if (nanoseconds > UINT64_MAX - magnitude) {
+        PyErr_Format(PyExc_OverflowError, "Subtraction leads to overflow in C storage.");
+        return NULL;
+      }
+      nanoseconds += magnitude;
+    }
+    return _rclpy_time_point_create(
+      Py_TYPE(a), nanoseconds, time_point->time_point.clock_type, time_point->pyclock_type);
+  }
+
+  Py_RETURN_NOTIMPLEMENTED;
 }
 
-/// Create a duration
+static PyNumberMethods rclpy_time_point_as_number = {
+  .nb_add = rclpy_time_point_add,
+  .nb_subtract = rclpy_time_point_subtract,
+};
+
+static PyGetSetDef rclpy_time_point_getset[] = {
+  {"nanoseconds", rclpy_time_point_get_nanoseconds, NULL,
+    "Nanoseconds since the epoch of the clock.", NULL},
+  {"clock_type", rclpy_time_point_get_clock_type, NULL,
+    "ClockType of the clock the time point belongs to.", NULL},
+  {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject rclpy_time_point_type = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "rclpy._rclpy.TimePoint",
+  .tp_basicsize = sizeof(rclpy_time_point_t),
+  .tp_dealloc = rclpy_time_point_dealloc,
+  .tp_as_number = &rclpy_time_point_as_number,
+  .tp_hash = PyObject_HashNotImplemented,
+  .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+  .tp_doc = "Point in time of a clock, stored as unsigned 64-bit nanoseconds.",
+  .tp_richcompare = rclpy_time_point_richcompare,
+  .tp_getset = rclpy_time_point_getset,
+  .tp_init = rclpy_time_point_init,
+  .tp_new = PyType_GenericNew,
+};
+
+/// Initialize a duration
 /**
- * On failure, an exception is raised and NULL is returned if:
- *
- * Raises RuntimeError on initialization failure
- * Raises TypeError if argument of invalid type
- * Raises OverflowError if nanoseconds argument cannot be converted to uint64_t
+ * Raises TypeError if nanoseconds is not an integer
+ * Raises OverflowError if nanoseconds cannot be converted to int64_t
  *
- * \param[in] nanoseconds unsigned PyLong object storing the nanoseconds value
+ * \param[in] nanoseconds PyLong object storing the nanoseconds value
  *   of the duration in a 64-bit signed integer
- * \return Capsule of the pointer to the created rcl_duration_t * structure, or
- * \return NULL on failure
+ * \return 0 on success, -1 on failure
  */
-static PyObject *
-rclpy_create_duration(PyObject * Py_UNUSED(self), PyObject * args)
+static int
+rclpy_duration_init(PyObject * self, PyObject * args, PyObject * kwds)
 {
+  static char * kwlist[] = {"nanoseconds", NULL};
   PY_LONG_LONG nanoseconds;
 
-  if (!PyArg_ParseTuple(args, "L", &nanoseconds)) {
-    return NULL;
-  }
-
-  rcl_duration_t * duration = (rcl_duration_t *) PyMem_Malloc(sizeof(rcl_duration_t));
-  if (NULL == duration) {
-    PyErr_Format(PyExc_RuntimeError, "Failed to allocate memory for duration.");
-    return NULL;
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "L:Duration", kwlist, &nanoseconds)) {
+    return -1;
   }
+  ((rclpy_duration_t *)self)->duration.nanoseconds = nanoseconds;
+  return 0;
+}
 
-  duration->nanoseconds = nanoseconds;
-
-  return PyCapsule_New(duration, "rcl_duration_t", _rclpy_destroy_duration);
+static PyObject *
+rclpy_duration_get_nanoseconds(PyObject * self, void * Py_UNUSED(closure))
+{
+  return PyLong_FromLongLong(((rclpy_duration_t *)self)->duration.nanoseconds);
 }
 
-/// Returns the nanoseconds value of the duration
+/// Compare two durations
 /**
- * On failure, an exception is raised and NULL is returned if:
- *
- * Raises ValueError if pyduration is not a duration capsule
- *
- * \param[in] pyduration Capsule pointing to the duration
- * \return NULL on failure:
- *         PyLong integer in nanoseconds on success
+ * Raises TypeError on == and != with anything but a duration, so that a mistake like
+ * `Duration(nanoseconds=5) == 5` doesn't quietly evaluate to False
  */
 static PyObject *
-rclpy_duration_get_nanoseconds(PyObject * Py_UNUSED(self), PyObject * args)
+rclpy_duration_richcompare(PyObject * a, PyObject * b, int op)
 {
-  PyObject * pyduration;
-  if (!PyArg_ParseTuple(args, "O", &pyduration)) {
-    return NULL;
+  if (!RCLPY_IS_DURATION(a) || !RCLPY_IS_DURATION(b)) {
+    if (Py_EQ == op || Py_NE == op) {
+      PyObject * other = RCLPY_IS_DURATION(a) ? b : a;
+      PyErr_Format(PyExc_TypeError,
+        "Can't compare duration with object of type: %s", Py_TYPE(other)->tp_name);
+      return NULL;
+    }
+    Py_RETURN_NOTIMPLEMENTED;
   }
+  RCLPY_RICHCOMPARE(
+    ((rclpy_duration_t *)a)->duration.nanoseconds,
+    ((rclpy_duration_t *)b)->duration.nanoseconds, op);
+}
 
-  rcl_duration_t * duration = (rcl_duration_t *)PyCapsule_GetPointer(
-    pyduration, "rcl_duration_t");
-  if (!duration) {
-    return NULL;
-  }
+static PyGetSetDef rclpy_duration_getset[] = {
+  {"nanoseconds", rclpy_duration_get_nanoseconds, NULL, "Length of the duration.", NULL},
+  {NULL, NULL, NULL, NULL, NULL}
+};
 
-  return PyLong_FromLongLong(duration->nanoseconds);
-}
+static PyTypeObject rclpy_duration_type = {
+  PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "rclpy._rclpy.Duration",
+  .tp_basicsize = sizeof(rclpy_duration_t),
+  .tp_hash = PyObject_HashNotImplemented,
+  .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+  .tp_doc = "Span of time, stored as signed 64-bit nanoseconds.",
+  .tp_richcompare = rclpy_duration_richcompare,
+  .tp_getset = rclpy_duration_getset,
+  .tp_init = rclpy_duration_init,
+  .tp_new = PyType_GenericNew,
+};
 
 /// Create a clock
 /**
@@ -3405,17 +5259,22 @@ rclpy_create_clock(PyObject * Py_UNUSED(self), PyObject * args)
  * On failure, an exception is raised and NULL is returned if:
  *
  * Raises ValueError if pyclock is not a clock capsule
+ * Raises TypeError if pytime_type is not a subclass of TimePoint
  * Raises RuntimeError if the clock's value cannot be retrieved
  *
  * \param[in] pyclock Capsule pointing to the clock
+ * \param[in] pytime_type TimePoint or a subclass of it to create
+ * \param[in] pyclock_type ClockType of the clock, stored in the time point
  * \return NULL on failure:
- *         Capsule to a time point on success
+ *         Instance of pytime_type on success
  */
 static PyObject *
 rclpy_clock_get_now(PyObject * Py_UNUSED(self), PyObject * args)
 {
   PyObject * pyclock;
-  if (!PyArg_ParseTuple(args, "O", &pyclock)) {
+  PyObject * pytime_type;
+  PyObject * pyclock_type;
+  if (!PyArg_ParseTuple(args, "OOO", &pyclock, &pytime_type, &pyclock_type)) {
     return NULL;
   }
 
@@ -3424,25 +5283,62 @@ rclpy_clock_get_now(PyObject * Py_UNUSED(self), PyObject * args)
   if (!clock) {
     return NULL;
   }
+  if (!PyType_Check(pytime_type) ||
+    !PyType_IsSubtype((PyTypeObject *)pytime_type, &rclpy_time_point_type))
+  {
+    PyErr_Format(PyExc_TypeError, "Time type must be a subclass of TimePoint");
+    return NULL;
+  }
+
+  rcl_time_point_value_t nanoseconds;
+  rcl_ret_t ret = rcl_clock_get_now(clock, &nanoseconds);
+
+  if (ret != RCL_RET_OK) {
+    PyErr_Format(PyExc_RuntimeError,
+      "Failed to get current value of clock: %s", rcl_get_error_string().str);
+    rcl_reset_error();
+    return NULL;
+  }
+
+  return _rclpy_time_point_create(
+    (PyTypeObject *)pytime_type, (uint64_t)nanoseconds, clock->type, pyclock_type);
+}
 
-  rcl_time_point_t * time_point = (rcl_time_point_t *) PyMem_Malloc(sizeof(rcl_time_point_t));
-  if (NULL == time_point) {
-    PyErr_Format(PyExc_RuntimeError, "Failed to allocate memory for time point.");
+/// Returns the current value of the clock in nanoseconds
+/**
+ * On failure, an exception is raised and NULL is returned if:
+ *
+ * Raises ValueError if pyclock is not a clock capsule
+ * Raises RuntimeError if the clock's value cannot be retrieved
+ *
+ * \param[in] pyclock Capsule pointing to the clock
+ * \return NULL on failure:
+ *         PyLong integer in nanoseconds on success
+ */
+static PyObject *
+rclpy_clock_get_now_ns(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pyclock;
+  if (!PyArg_ParseTuple(args, "O", &pyclock)) {
     return NULL;
   }
-  time_point->clock_type = clock->type;
 
-  rcl_ret_t ret = rcl_clock_get_now(clock, &time_point->nanoseconds);
+  rcl_clock_t * clock = (rcl_clock_t *)PyCapsule_GetPointer(
+    pyclock, "rcl_clock_t");
+  if (!clock) {
+    return NULL;
+  }
 
+  rcl_time_point_value_t nanoseconds;
+  rcl_ret_t ret = rcl_clock_get_now(clock, &nanoseconds);
   if (ret != RCL_RET_OK) {
     PyErr_Format(PyExc_RuntimeError,
       "Failed to get current value of clock: %s", rcl_get_error_string().str);
     rcl_reset_error();
-    PyMem_Free(time_point);
     return NULL;
   }
 
-  return PyCapsule_New(time_point, "rcl_time_point_t", _rclpy_destroy_time_point);
+  return PyLong_FromUnsignedLongLong((uint64_t)nanoseconds);
 }
 
 /// Returns if a clock using ROS time has the ROS time override enabled.
@@ -3537,12 +5433,12 @@ rclpy_clock_set_ros_time_override_is_enabled(PyObject * Py_UNUSED(self), PyObjec
 /**
  * On failure, an exception is raised and NULL is returned if:
  *
- * Raises ValueError if pyclock is not a clock capsule, or
- * pytime_point is not a time point capsule
+ * Raises ValueError if pyclock is not a clock capsule
+ * Raises TypeError if pytime_point is not a TimePoint
  * Raises RuntimeError if the clock's ROS time override cannot be set
  *
  * \param[in] pyclock Capsule pointing to the clock to set
- * \param[in] pytime_point Capsule pointing to the time point
+ * \param[in] pytime_point TimePoint to set the clock to
  * \return NULL on failure
  *         None on success
  */
@@ -3561,11 +5457,11 @@ rclpy_clock_set_ros_time_override(PyObject * Py_UNUSED(self), PyObject * args)
     return NULL;
   }
 
-  rcl_time_point_t * time_point = (rcl_time_point_t *)PyCapsule_GetPointer(
-    pytime_point, "rcl_time_point_t");
-  if (!time_point) {
+  if (!RCLPY_IS_TIME_POINT(pytime_point)) {
+    PyErr_Format(PyExc_TypeError, "Time must be a TimePoint");
     return NULL;
   }
+  rcl_time_point_t * time_point = &((rclpy_time_point_t *)pytime_point)->time_point;
 
   rcl_ret_t ret = rcl_set_ros_time_override(clock, time_point->nanoseconds);
   if (ret != RCL_RET_OK) {
@@ -3582,6 +5478,165 @@ rclpy_clock_set_ros_time_override(PyObject * Py_UNUSED(self), PyObject * args)
   Py_RETURN_NONE;
 }
 
+/// Clocks using ROS time whose override is set together
+typedef struct
+{
+  /// Clock capsules in the group, each one holding a reference
+  PyObject ** pyclocks;
+  /// Clocks in the same order as pyclocks
+  rcl_clock_t ** clocks;
+  size_t size;
+  size_t capacity;
+} rclpy_clock_group_t;
+
+/// Destructor for a clock group
+static void
+_rclpy_destroy_clock_group(PyObject * pycapsule)
+{
+  rclpy_clock_group_t * group = (rclpy_clock_group_t *)PyCapsule_GetPointer(
+    pycapsule, "rclpy_clock_group_t");
+  if (!group) {
+    PyErr_Clear();
+    return;
+  }
+  for (size_t i = 0; i < group->size; ++i) {
+    Py_DECREF(group->pyclocks[i]);
+  }
+  PyMem_Free(group->pyclocks);
+  PyMem_Free(group->clocks);
+  PyMem_Free(group);
+}
+
+/// Create an empty clock group
+/**
+ * A clock group lets a time source set the ROS time override of many clocks in one call,
+ * e.g. once per message on /clock.
+ *
+ * Raises MemoryError if the group cannot be allocated
+ *
+ * \return Capsule pointing to the clock group
+ */
+static PyObject *
+rclpy_create_clock_group(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
+{
+  rclpy_clock_group_t * group = PyMem_Malloc(sizeof(rclpy_clock_group_t));
+  if (!group) {
+    return PyErr_NoMemory();
+  }
+  group->pyclocks = NULL;
+  group->clocks = NULL;
+  group->size = 0;
+  group->capacity = 0;
+
+  PyObject * pygroup = PyCapsule_New(group, "rclpy_clock_group_t", _rclpy_destroy_clock_group);
+  if (!pygroup) {
+    PyMem_Free(group);
+  }
+  return pygroup;
+}
+
+/// Add a clock to a clock group
+/**
+ * The group keeps the clock alive until the group is destroyed.
+ *
+ * Raises ValueError if pygroup is not a clock group capsule or pyclock is not a clock capsule,
+ * or if the clock does not use ROS time
+ * Raises MemoryError if the group cannot grow
+ *
+ * \param[in] pygroup Capsule pointing to the clock group
+ * \param[in] pyclock Capsule pointing to the clock to add
+ * \return None
+ */
+static PyObject *
+rclpy_clock_group_add(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pygroup;
+  PyObject * pyclock;
+  if (!PyArg_ParseTuple(args, "OO", &pygroup, &pyclock)) {
+    return NULL;
+  }
+
+  rclpy_clock_group_t * group = (rclpy_clock_group_t *)PyCapsule_GetPointer(
+    pygroup, "rclpy_clock_group_t");
+  if (!group) {
+    return NULL;
+  }
+  rcl_clock_t * clock = (rcl_clock_t *)PyCapsule_GetPointer(pyclock, "rcl_clock_t");
+  if (!clock) {
+    return NULL;
+  }
+  if (clock->type != RCL_ROS_TIME) {
+    PyErr_Format(PyExc_ValueError, "Only clocks with type ROS_TIME can be added to a group");
+    return NULL;
+  }
+
+  if (group->size == group->capacity) {
+    size_t capacity = group->capacity ? group->capacity * 2 : 4;
+    PyObject ** pyclocks = PyMem_Realloc(group->pyclocks, capacity * sizeof(PyObject *));
+    if (!pyclocks) {
+      return PyErr_NoMemory();
+    }
+    group->pyclocks = pyclocks;
+    rcl_clock_t ** clocks = PyMem_Realloc(group->clocks, capacity * sizeof(rcl_clock_t *));
+    if (!clocks) {
+      return PyErr_NoMemory();
+    }
+    group->clocks = clocks;
+    group->capacity = capacity;
+  }
+  Py_INCREF(pyclock);
+  group->pyclocks[group->size] = pyclock;
+  group->clocks[group->size] = clock;
+  ++group->size;
+  Py_RETURN_NONE;
+}
+
+/// Set the ROS time override of every clock in a clock group
+/**
+ * rcl only dispatches the time jump callbacks of a clock whose thresholds the change crosses,
+ * so clocks without callbacks, or with a jump below their thresholds, never reach Python.
+ *
+ * Raises ValueError if pygroup is not a clock group capsule
+ * Raises OverflowError if nanoseconds cannot be converted to uint64_t
+ * Raises RuntimeError if a clock's ROS time override cannot be set
+ *
+ * \param[in] pygroup Capsule pointing to the clock group
+ * \param[in] nanoseconds time to set the clocks to
+ * \return NULL on failure, or if a time jump callback raised
+ *         None on success
+ */
+static PyObject *
+rclpy_clock_group_set_ros_time_override(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pygroup;
+  unsigned PY_LONG_LONG nanoseconds;
+  if (!PyArg_ParseTuple(args, "OK", &pygroup, &nanoseconds)) {
+    return NULL;
+  }
+
+  rclpy_clock_group_t * group = (rclpy_clock_group_t *)PyCapsule_GetPointer(
+    pygroup, "rclpy_clock_group_t");
+  if (!group) {
+    return NULL;
+  }
+
+  for (size_t i = 0; i < group->size; ++i) {
+    rcl_ret_t ret = rcl_set_ros_time_override(
+      group->clocks[i], (rcl_time_point_value_t)nanoseconds);
+    if (ret != RCL_RET_OK) {
+      PyErr_Format(PyExc_RuntimeError,
+        "Failed to set ROS time override for clock: %s", rcl_get_error_string().str);
+      rcl_reset_error();
+      return NULL;
+    }
+    if (PyErr_Occurred()) {
+      // Time jump callbacks raised
+      return NULL;
+    }
+  }
+  Py_RETURN_NONE;
+}
+
 /// Called when a time jump occurs.
 void
 _rclpy_on_time_jump(
@@ -3964,27 +6019,22 @@ _populate_node_parameters_from_rcl_params(
   return true;
 }
 
-/// Populate a Python dict with node parameters parsed from arguments files
+/// Append the parameters files named in arguments to a Python list
 /**
  * On failure a Python exception is raised and false is returned if:
  *
  * Raises RuntimeError if param_files cannot be extracted from arguments.
- * Raises RuntimeError if yaml files do not parse succesfully.
  *
- * \param[in] args The arguments to parse for parameter files
+ * \param[in] args The arguments to get parameter files from
  * \param[in] allocator Allocator to use for allocating and deallocating within the function.
- * \param[in] parameter_cls The PythonObject for the Parameter class.
- * \param[in] parameter_type_cls The PythonObject for the Parameter.Type class.
- * \param[out] params_by_node_name A Python dict object to place parsed parameters into.
- *
- * Returns true when parameters are parsed successfully (including the trivial case)
- *         false when there was an error during parsing and a Python exception was raised.
+ * \param[out] pyparam_files A Python list to append the file paths to.
  *
+ * Returns true when the files were appended successfully (including the trivial case)
+ *         false when there was an error and a Python exception was raised.
  */
 static bool
-_parse_param_files(
-  const rcl_arguments_t * args, rcl_allocator_t allocator, PyObject * parameter_cls,
-  PyObject * parameter_type_cls, PyObject * params_by_node_name)
+_append_param_files(
+  const rcl_arguments_t * args, rcl_allocator_t allocator, PyObject * pyparam_files)
 {
   char ** param_files;
   int param_files_count = rcl_arguments_get_param_files_count(args);
@@ -3995,25 +6045,16 @@ _parse_param_files(
   if (RCL_RET_OK != rcl_arguments_get_param_files(args, allocator, &param_files)) {
     PyErr_Format(PyExc_RuntimeError, "Failed to get initial parameters: %s",
       rcl_get_error_string().str);
+    rcl_reset_error();
     return false;
   }
   for (int i = 0; i < param_files_count; ++i) {
     if (successful) {
-      rcl_params_t * params = rcl_yaml_node_struct_init(allocator);
-      if (!rcl_parse_yaml_file(param_files[i], params)) {
-        // failure to parse will automatically fini the params struct
-        PyErr_Format(PyExc_RuntimeError, "Failed to parse yaml params file '%s': %s",
-          param_files[i], rcl_get_error_string().str);
-        rcl_reset_error();
+      PyObject * pyparam_file = PyUnicode_FromString(param_files[i]);
+      if (NULL == pyparam_file || -1 == PyList_Append(pyparam_files, pyparam_file)) {
         successful = false;
-      } else {
-        if (!_populate_node_parameters_from_rcl_params(
-            params, allocator, parameter_cls, parameter_type_cls, params_by_node_name))
-        {
-          successful = false;
-        }
-        rcl_yaml_node_struct_fini(params);
       }
+      Py_XDECREF(pyparam_file);
     }
     allocator.deallocate(param_files[i], allocator.state);
   }
@@ -4021,24 +6062,22 @@ _parse_param_files(
   return successful;
 }
 
-/// Get a list of parameters for the current node from rcl_yaml_param_parser
+/// Get the parameters files that apply to a node
 /**
  * On failure, an exception is raised and NULL is returned if:
  *
  * Raises ValueError if the argument is not a node handle.
- * Raises RuntimeError if the parameters file fails to parse
+ * Raises RuntimeError if the files cannot be extracted from the arguments.
  *
- * \param[in] parameter_cls The rclpy.parameter.Parameter class object.
  * \param[in] node_capsule Capsule pointing to the node handle
  * \return NULL on failure
- *         A dict mapping parameter names to rclpy.parameter.Parameter on success (may be empty).
+ *         A list of file paths on success, global ones first; later files take precedence
  */
 static PyObject *
-rclpy_get_node_parameters(PyObject * Py_UNUSED(self), PyObject * args)
+rclpy_get_node_param_files(PyObject * Py_UNUSED(self), PyObject * args)
 {
-  PyObject * parameter_cls;
   PyObject * node_capsule;
-  if (!PyArg_ParseTuple(args, "OO", &parameter_cls, &node_capsule)) {
+  if (!PyArg_ParseTuple(args, "O", &node_capsule)) {
     return NULL;
   }
 
@@ -4047,20 +6086,8 @@ rclpy_get_node_parameters(PyObject * Py_UNUSED(self), PyObject * args)
     return NULL;
   }
 
-  PyObject * params_by_node_name = PyDict_New();
-  if (NULL == params_by_node_name) {
-    return NULL;
-  }
-
-  if (!PyObject_HasAttrString(parameter_cls, "Type")) {
-    PyErr_Format(PyExc_RuntimeError, "Parameter class is missing 'Type' attribute");
-    Py_DECREF(params_by_node_name);
-    return NULL;
-  }
-  PyObject * parameter_type_cls = PyObject_GetAttrString(parameter_cls, "Type");
-  if (NULL == parameter_type_cls) {
-    // PyObject_GetAttrString raises AttributeError on failure.
-    Py_DECREF(params_by_node_name);
+  PyObject * pyparam_files = PyList_New(0);
+  if (NULL == pyparam_files) {
     return NULL;
   }
 
@@ -4068,58 +6095,80 @@ rclpy_get_node_parameters(PyObject * Py_UNUSED(self), PyObject * args)
   const rcl_allocator_t allocator = node_options->allocator;
 
   if (node_options->use_global_arguments) {
-    if (!_parse_param_files(
-        &(node->context->global_arguments), allocator, parameter_cls,
-        parameter_type_cls, params_by_node_name))
-    {
-      Py_DECREF(parameter_type_cls);
-      Py_DECREF(params_by_node_name);
+    if (!_append_param_files(&(node->context->global_arguments), allocator, pyparam_files)) {
+      Py_DECREF(pyparam_files);
       return NULL;
     }
   }
+  if (!_append_param_files(&(node_options->arguments), allocator, pyparam_files)) {
+    Py_DECREF(pyparam_files);
+    return NULL;
+  }
+  return pyparam_files;
+}
 
-  if (!_parse_param_files(&(node_options->arguments), allocator, parameter_cls,
-    parameter_type_cls, params_by_node_name))
-  {
-    Py_DECREF(parameter_type_cls);
-    Py_DECREF(params_by_node_name);
+/// Parse a YAML parameters file with rcl_yaml_param_parser
+/**
+ * On failure, an exception is raised and NULL is returned if:
+ *
+ * Raises RuntimeError if the parameters file fails to parse
+ *
+ * \param[in] parameter_cls The rclpy.parameter.Parameter class object.
+ * \param[in] param_file Path of the file to parse
+ * \return NULL on failure
+ *         A dict mapping fully qualified node names to dicts of parameter names to
+ *         rclpy.parameter.Parameter on success (may be empty).
+ */
+static PyObject *
+rclpy_parse_param_file(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * parameter_cls;
+  const char * param_file;
+  if (!PyArg_ParseTuple(args, "Os", &parameter_cls, &param_file)) {
     return NULL;
   }
-  Py_DECREF(parameter_type_cls);
 
-  const char * node_namespace = rcl_node_get_namespace(node);
-  char * node_name_with_namespace;
-  if ('/' == node_namespace[strlen(node_namespace) - 1]) {
-    node_name_with_namespace = rcutils_format_string(allocator, "%s%s",
-        node_namespace, rcl_node_get_name(node));
-  } else {
-    node_name_with_namespace = rcutils_format_string(allocator, "%s/%s",
-        node_namespace, rcl_node_get_name(node));
+  if (!PyObject_HasAttrString(parameter_cls, "Type")) {
+    PyErr_Format(PyExc_RuntimeError, "Parameter class is missing 'Type' attribute");
+    return NULL;
+  }
+  PyObject * parameter_type_cls = PyObject_GetAttrString(parameter_cls, "Type");
+  if (NULL == parameter_type_cls) {
+    // PyObject_GetAttrString raises AttributeError on failure.
+    return NULL;
   }
 
-  PyObject * py_node_name_with_namespace = PyUnicode_FromString(node_name_with_namespace);
-  allocator.deallocate(node_name_with_namespace, allocator.state);
-  if (NULL == py_node_name_with_namespace) {
-    Py_DECREF(params_by_node_name);
+  PyObject * params_by_node_name = PyDict_New();
+  if (NULL == params_by_node_name) {
+    Py_DECREF(parameter_type_cls);
     return NULL;
   }
 
-  if (!PyDict_Contains(params_by_node_name, py_node_name_with_namespace)) {
-    // No parameters for current node.
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_params_t * params = rcl_yaml_node_struct_init(allocator);
+  if (NULL == params) {
+    Py_DECREF(parameter_type_cls);
+    Py_DECREF(params_by_node_name);
+    return PyErr_NoMemory();
+  }
+  if (!rcl_parse_yaml_file(param_file, params)) {
+    // failure to parse will automatically fini the params struct
+    PyErr_Format(PyExc_RuntimeError, "Failed to parse yaml params file '%s': %s",
+      param_file, rcl_get_error_string().str);
+    rcl_reset_error();
+    Py_DECREF(parameter_type_cls);
     Py_DECREF(params_by_node_name);
-    Py_DECREF(py_node_name_with_namespace);
-    return PyDict_New();
+    return NULL;
   }
-  PyObject * node_params = PyDict_GetItem(params_by_node_name, py_node_name_with_namespace);
-  Py_DECREF(py_node_name_with_namespace);
-  if (NULL == node_params) {
+  bool successful = _populate_node_parameters_from_rcl_params(
+    params, allocator, parameter_cls, parameter_type_cls, params_by_node_name);
+  rcl_yaml_node_struct_fini(params);
+  Py_DECREF(parameter_type_cls);
+  if (!successful) {
     Py_DECREF(params_by_node_name);
     return NULL;
   }
-  // PyDict_GetItem is a borrowed reference. INCREF so we can return a new one.
-  Py_INCREF(node_params);
-  Py_DECREF(params_by_node_name);
-  return node_params;
+  return params_by_node_name;
 }
 
 
@@ -4193,6 +6242,22 @@ static PyMethodDef rclpy_methods[] = {
     "rclpy_create_subscription", rclpy_create_subscription, METH_VARARGS,
     "Create a Subscription."
   },
+  {
+    "rclpy_create_content_filter", rclpy_create_content_filter, METH_VARARGS,
+    "Create a content filter for a subscription."
+  },
+  {
+    "rclpy_create_latency_tracker", rclpy_create_latency_tracker, METH_VARARGS,
+    "Create a latency tracker for a subscription."
+  },
+  {
+    "rclpy_latency_tracker_get_stats", rclpy_latency_tracker_get_stats, METH_VARARGS,
+    "Get the statistics recorded by a latency tracker."
+  },
+  {
+    "rclpy_latency_tracker_reset", rclpy_latency_tracker_reset, METH_VARARGS,
+    "Clear the statistics recorded by a latency tracker."
+  },
   {
     "rclpy_create_service", rclpy_create_service, METH_VARARGS,
     "Create a Service."
@@ -4210,6 +6275,10 @@ static PyMethodDef rclpy_methods[] = {
     "rclpy_get_sigint_guard_condition", rclpy_get_sigint_guard_condition, METH_VARARGS,
     "Create a guard_condition triggered when sigint is received."
   },
+  {
+    "rclpy_get_graph_guard_condition", rclpy_get_graph_guard_condition, METH_VARARGS,
+    "Get the guard condition of a node triggered when the ROS graph changes."
+  },
   {
     "rclpy_create_guard_condition", rclpy_create_guard_condition, METH_VARARGS,
     "Create a general purpose guard_condition."
@@ -4232,10 +6301,30 @@ static PyMethodDef rclpy_methods[] = {
     "rclpy_publish", rclpy_publish, METH_VARARGS,
     "Publish a message."
   },
+  {
+    "rclpy_create_publish_queue", rclpy_create_publish_queue, METH_VARARGS,
+    "Create a publish queue with its background thread."
+  },
+  {
+    "rclpy_publish_queue_push", rclpy_publish_queue_push, METH_VARARGS,
+    "Queue a message to be published by the background thread."
+  },
+  {
+    "rclpy_publish_queue_stop", rclpy_publish_queue_stop, METH_VARARGS,
+    "Stop a publish queue once the queued messages are published."
+  },
+  {
+    "rclpy_publish_queue_get_stats", rclpy_publish_queue_get_stats, METH_VARARGS,
+    "Get the state of a publish queue."
+  },
   {
     "rclpy_send_request", rclpy_send_request, METH_VARARGS,
     "Send a request."
   },
+  {
+    "rclpy_send_requests", rclpy_send_requests, METH_VARARGS,
+    "Send a batch of requests."
+  },
   {
     "rclpy_send_response", rclpy_send_response, METH_VARARGS,
     "Send a response."
@@ -4345,6 +6434,10 @@ static PyMethodDef rclpy_methods[] = {
     "rclpy_take_response", rclpy_take_response, METH_VARARGS,
     "rclpy_take_response."
   },
+  {
+    "rclpy_wait_and_take_response", rclpy_wait_and_take_response, METH_VARARGS,
+    "Wait for a response to a client and take it."
+  },
 
   {
     "rclpy_ok", rclpy_ok, METH_VARARGS,
@@ -4361,8 +6454,12 @@ static PyMethodDef rclpy_methods[] = {
     "Get node names and namespaces list from graph API."
   },
   {
-    "rclpy_get_node_parameters", rclpy_get_node_parameters, METH_VARARGS,
-    "Get the initial parameters for a node from the command line."
+    "rclpy_get_node_param_files", rclpy_get_node_param_files, METH_VARARGS,
+    "Get the parameters files that apply to a node."
+  },
+  {
+    "rclpy_parse_param_file", rclpy_parse_param_file, METH_VARARGS,
+    "Parse a YAML parameters file into parameters by node name."
   },
   {
     "rclpy_get_topic_names_and_types", rclpy_get_topic_names_and_types, METH_VARARGS,
@@ -4389,48 +6486,49 @@ static PyMethodDef rclpy_methods[] = {
   },
 
   {
-    "rclpy_create_time_point", rclpy_create_time_point, METH_VARARGS,
-    "Create a time point."
+    "rclpy_create_clock", rclpy_create_clock, METH_VARARGS,
+    "Create a clock."
   },
 
   {
-    "rclpy_time_point_get_nanoseconds", rclpy_time_point_get_nanoseconds, METH_VARARGS,
-    "Get the nanoseconds value of a time point."
+    "rclpy_clock_get_now", rclpy_clock_get_now, METH_VARARGS,
+    "Get the current value of a clock."
   },
 
   {
-    "rclpy_create_duration", rclpy_create_duration, METH_VARARGS,
-    "Create a duration."
+    "rclpy_clock_get_now_ns", rclpy_clock_get_now_ns, METH_VARARGS,
+    "Get the current value of a clock in nanoseconds."
   },
 
   {
-    "rclpy_duration_get_nanoseconds", rclpy_duration_get_nanoseconds, METH_VARARGS,
-    "Get the nanoseconds value of a duration."
+    "rclpy_clock_get_ros_time_override_is_enabled", rclpy_clock_get_ros_time_override_is_enabled,
+    METH_VARARGS, "Get if a clock using ROS time has the ROS time override enabled."
   },
 
   {
-    "rclpy_create_clock", rclpy_create_clock, METH_VARARGS,
-    "Create a clock."
+    "rclpy_clock_set_ros_time_override_is_enabled", rclpy_clock_set_ros_time_override_is_enabled,
+    METH_VARARGS, "Set if a clock using ROS time has the ROS time override enabled."
   },
 
   {
-    "rclpy_clock_get_now", rclpy_clock_get_now, METH_VARARGS,
-    "Get the current value of a clock."
+    "rclpy_clock_set_ros_time_override", rclpy_clock_set_ros_time_override, METH_VARARGS,
+    "Set the current time of a clock using ROS time."
   },
 
   {
-    "rclpy_clock_get_ros_time_override_is_enabled", rclpy_clock_get_ros_time_override_is_enabled,
-    METH_VARARGS, "Get if a clock using ROS time has the ROS time override enabled."
+    "rclpy_create_clock_group", rclpy_create_clock_group, METH_NOARGS,
+    "Create a group of clocks using ROS time."
   },
 
   {
-    "rclpy_clock_set_ros_time_override_is_enabled", rclpy_clock_set_ros_time_override_is_enabled,
-    METH_VARARGS, "Set if a clock using ROS time has the ROS time override enabled."
+    "rclpy_clock_group_add", rclpy_clock_group_add, METH_VARARGS,
+    "Add a clock to a clock group."
   },
 
   {
-    "rclpy_clock_set_ros_time_override", rclpy_clock_set_ros_time_override, METH_VARARGS,
-    "Set the current time of a clock using ROS time."
+    "rclpy_clock_group_set_ros_time_override", rclpy_clock_group_set_ros_time_override,
+    METH_VARARGS,
+    "Set the current time of every clock in a clock group."
   },
 
   {
@@ -4465,5 +6563,37 @@ static struct PyModuleDef _rclpymodule = {
 /// Init function of this module
 PyMODINIT_FUNC PyInit__rclpy(void)
 {
-  return PyModule_Create(&_rclpymodule);
+  if (PyType_Ready(&rclpy_duration_type) < 0) {
+    return NULL;
+  }
+  if (PyType_Ready(&rclpy_time_point_type) < 0) {
+    return NULL;
+  }
+  if (PyDict_SetItemString(
+      rclpy_time_point_type.tp_dict, "_duration_type", (PyObject *)&rclpy_duration_type) < 0)
+  {
+    return NULL;
+  }
+  g_duration_type_attr = PyUnicode_InternFromString("_duration_type");
+  if (!g_duration_type_attr) {
+    return NULL;
+  }
+
+  PyObject * pymodule = PyModule_Create(&_rclpymodule);
+  if (!pymodule) {
+    return NULL;
+  }
+  Py_INCREF(&rclpy_time_point_type);
+  if (PyModule_AddObject(pymodule, "TimePoint", (PyObject *)&rclpy_time_point_type) < 0) {
+    Py_DECREF(&rclpy_time_point_type);
+    Py_DECREF(pymodule);
+    return NULL;
+  }
+  Py_INCREF(&rclpy_duration_type);
+  if (PyModule_AddObject(pymodule, "Duration", (PyObject *)&rclpy_duration_type) < 0) {
+    Py_DECREF(&rclpy_duration_type);
+    Py_DECREF(pymodule);
+    return NULL;
+  }
+  return pymodule;
 }
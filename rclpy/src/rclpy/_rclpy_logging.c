@@ -13,18 +13,718 @@
 // limitations under the License.
 
 #include <Python.h>
+#include <frameobject.h>
 
 #include <rcutils/error_handling.h>
 #include <rcutils/logging.h>
 #include <rcutils/time.h>
 
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+/// Number of times the logger levels may have changed
+static unsigned PY_LONG_LONG g_logger_level_generation = 0;
+
+/// Invalidate the effective levels cached by rclpy loggers
+/**
+ * Loggers compare the `logger_level_generation` attribute of the module with the one their
+ * cached level was read at, so a disabled log call costs no call into this module.
+ *
+ * \param[in] module This module
+ * \return 0 on success, -1 with a Python exception set on failure
+ */
+static int
+_bump_logger_level_generation(PyObject * module)
+{
+  PyObject * pygeneration = PyLong_FromUnsignedLongLong(++g_logger_level_generation);
+  if (NULL == pygeneration) {
+    return -1;
+  }
+  int ret = PyObject_SetAttrString(module, "logger_level_generation", pygeneration);
+  Py_DECREF(pygeneration);
+  return ret;
+}
+
+/// A log record waiting to be written by the asynchronous logging thread
+/**
+ * The strings are stored in the same allocation, after the struct.
+ */
+typedef struct
+{
+  int severity;
+  rcutils_time_point_value_t timestamp;
+  rcutils_log_location_t location;
+  const char * name;
+  const char * message;
+} rclpy_log_record_t;
+
+/// State of asynchronous logging
+/**
+ * The ring buffer and the counters are protected by `lock`, which is only held to move record
+ * pointers, so logging calls don't wait for output.
+ * The background thread never takes the GIL: neither a slow output handler nor Python code
+ * holding the GIL delays the other.
+ * `records_event` is used as a binary event: it is released only if `worker_waiting` was set,
+ * and the flag is cleared when it is.
+ */
+typedef struct
+{
+  /// Ring buffer of queued records
+  rclpy_log_record_t ** records;
+  /// Records taken by the background thread, being written
+  rclpy_log_record_t ** batch;
+  size_t capacity;
+  size_t head;
+  size_t size;
+  /// Records dropped because the buffer was full
+  uint64_t dropped;
+  /// Records written by the background thread
+  uint64_t written;
+  /// True while the background thread is running and accepting records
+  bool running;
+  /// True from the time stopping starts until the state is released
+  bool stopping;
+  bool worker_waiting;
+  PyThread_type_lock lock;
+  PyThread_type_lock records_event;
+  /// Released by the background thread when it exits
+  PyThread_type_lock done_event;
+} rclpy_async_logging_t;
+
+static rclpy_async_logging_t g_async_logging;
+/// Held by the thread stopping asynchronous logging, allocated with the module
+static PyThread_type_lock g_async_logging_stop_lock;
+
+/// Call a logging output handler with a message that is not a format string
+static void
+_call_output_handler(
+  rcutils_logging_output_handler_t output_handler, const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp, const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  output_handler(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+/// Wake the background thread if it waits for records, with the lock held
+static void
+_async_logging_wake_worker(rclpy_async_logging_t * async_logging)
+{
+  if (async_logging->worker_waiting) {
+    async_logging->worker_waiting = false;
+    PyThread_release_lock(async_logging->records_event);
+  }
+}
+
+/// Body of the asynchronous logging thread
+/**
+ * Writes records until asynchronous logging is disabled and the buffer is empty.
+ */
+static void
+_async_logging_thread(void * Py_UNUSED(arg))
+{
+  rclpy_async_logging_t * async_logging = &g_async_logging;
+  PyThread_acquire_lock(async_logging->lock, WAIT_LOCK);
+  while (true) {
+    if (0 == async_logging->size) {
+      if (!async_logging->running) {
+        break;
+      }
+      async_logging->worker_waiting = true;
+      PyThread_release_lock(async_logging->lock);
+      PyThread_acquire_lock(async_logging->records_event, WAIT_LOCK);
+      PyThread_acquire_lock(async_logging->lock, WAIT_LOCK);
+      continue;
+    }
+    // Take the whole backlog so the lock is not held while writing
+    size_t count = async_logging->size;
+    for (size_t i = 0; i < count; ++i) {
+      async_logging->batch[i] = async_logging->records[async_logging->head];
+      async_logging->records[async_logging->head] = NULL;
+      async_logging->head = (async_logging->head + 1) % async_logging->capacity;
+    }
+    async_logging->size = 0;
+    PyThread_release_lock(async_logging->lock);
+
+    rcutils_logging_output_handler_t output_handler = rcutils_logging_get_output_handler();
+    for (size_t i = 0; i < count; ++i) {
+      rclpy_log_record_t * record = async_logging->batch[i];
+      if (NULL != output_handler) {
+        _call_output_handler(
+          output_handler, &record->location, record->severity, record->name,
+          record->timestamp, "%s", record->message);
+      }
+      PyMem_RawFree(record);
+    }
+
+    PyThread_acquire_lock(async_logging->lock, WAIT_LOCK);
+    async_logging->written += count;
+  }
+  PyThread_release_lock(async_logging->lock);
+  // The buffer is freed once this is released, don't touch it afterwards
+  PyThread_release_lock(async_logging->done_event);
+}
+
+static void
+_async_logging_fini(rclpy_async_logging_t * async_logging)
+{
+  if (async_logging->records) {
+    for (size_t i = 0; i < async_logging->capacity; ++i) {
+      PyMem_RawFree(async_logging->records[i]);
+    }
+    PyMem_Free(async_logging->records);
+  }
+  PyMem_Free(async_logging->batch);
+  if (async_logging->lock) {
+    PyThread_free_lock(async_logging->lock);
+  }
+  if (async_logging->records_event) {
+    PyThread_free_lock(async_logging->records_event);
+  }
+  if (async_logging->done_event) {
+    PyThread_free_lock(async_logging->done_event);
+  }
+  uint64_t dropped = async_logging->dropped;
+  uint64_t written = async_logging->written;
+  memset(async_logging, 0, sizeof(rclpy_async_logging_t));
+  // Keep the counters across enabling and disabling
+  async_logging->dropped = dropped;
+  async_logging->written = written;
+}
+
+/// Stop the asynchronous logging thread after it wrote the queued records
+/**
+ * Must be called with the GIL held.
+ * The GIL is released while the queued records are written, so `stopping` stays set until the
+ * state is released: enabling asynchronous logging fails meanwhile, and concurrent calls wait
+ * on the stop lock until the thread stopping it is done.
+ */
+static void
+_async_logging_stop(rclpy_async_logging_t * async_logging)
+{
+  if (!async_logging->running && !async_logging->stopping) {
+    return;
+  }
+  Py_BEGIN_ALLOW_THREADS;
+  PyThread_acquire_lock(g_async_logging_stop_lock, WAIT_LOCK);
+  Py_END_ALLOW_THREADS;
+  if (!async_logging->running) {
+    // Stopped by another thread meanwhile
+    PyThread_release_lock(g_async_logging_stop_lock);
+    return;
+  }
+  async_logging->stopping = true;
+  PyThread_acquire_lock(async_logging->lock, WAIT_LOCK);
+  async_logging->running = false;
+  _async_logging_wake_worker(async_logging);
+  PyThread_release_lock(async_logging->lock);
+  Py_BEGIN_ALLOW_THREADS;
+  PyThread_acquire_lock(async_logging->done_event, WAIT_LOCK);
+  Py_END_ALLOW_THREADS;
+  _async_logging_fini(async_logging);
+  async_logging->stopping = false;
+  PyThread_release_lock(g_async_logging_stop_lock);
+}
+
+/// Queue a record for the asynchronous logging thread
+/**
+ * \return false if the record was dropped because the buffer was full or memory ran out
+ */
+static bool
+_async_logging_push(
+  rclpy_async_logging_t * async_logging, int severity, const char * name,
+  const char * message, const char * function_name, const char * file_name, size_t line_number)
+{
+  size_t name_size = strlen(name) + 1;
+  size_t message_size = strlen(message) + 1;
+  size_t function_name_size = strlen(function_name) + 1;
+  size_t file_name_size = strlen(file_name) + 1;
+  rclpy_log_record_t * record = (rclpy_log_record_t *)PyMem_RawMalloc(
+    sizeof(rclpy_log_record_t) + name_size + message_size + function_name_size + file_name_size);
+  if (NULL == record) {
+    PyThread_acquire_lock(async_logging->lock, WAIT_LOCK);
+    async_logging->dropped++;
+    PyThread_release_lock(async_logging->lock);
+    return false;
+  }
+  char * strings = (char *)(record + 1);
+  record->severity = severity;
+  if (RCUTILS_RET_OK != rcutils_system_time_now(&record->timestamp)) {
+    rcutils_reset_error();
+    record->timestamp = 0;
+  }
+  record->name = memcpy(strings, name, name_size);
+  strings += name_size;
+  record->message = memcpy(strings, message, message_size);
+  strings += message_size;
+  record->location.function_name = memcpy(strings, function_name, function_name_size);
+  strings += function_name_size;
+  record->location.file_name = memcpy(strings, file_name, file_name_size);
+  record->location.line_number = line_number;
+
+  PyThread_acquire_lock(async_logging->lock, WAIT_LOCK);
+  bool queued = async_logging->size < async_logging->capacity;
+  if (queued) {
+    async_logging->records[(async_logging->head + async_logging->size) %
+      async_logging->capacity] = record;
+    async_logging->size++;
+    _async_logging_wake_worker(async_logging);
+  } else {
+    async_logging->dropped++;
+  }
+  PyThread_release_lock(async_logging->lock);
+  if (!queued) {
+    PyMem_RawFree(record);
+  }
+  return queued;
+}
+
+/// Layout version of binary log files
+#define RCLPY_BINARY_LOG_VERSION 1
+#define RCLPY_BINARY_LOG_HEADER_SIZE 128
+#define RCLPY_BINARY_LOG_MIN_SIZE (64 * 1024)
+/// Longest message stored, longer ones are truncated
+#define RCLPY_BINARY_LOG_MAX_MESSAGE_SIZE 4096
+#define RCLPY_BINARY_LOG_ENTRY_LOGGER_NAME 1
+#define RCLPY_BINARY_LOG_ENTRY_LOCATION 2
+
+/// Header at the start of a binary log file
+/**
+ * A binary log file has three regions: this header, an append-only region of string entries
+ * defining the ids of logger names and locations, and a ring of records.
+ * All integers are in the byte order of the writer, given by `byte_order`.
+ * The offsets and counters are updated only after the data they cover is written, so the file
+ * stays consistent if the process crashes, as long as the operating system does not.
+ */
+typedef struct
+{
+  char magic[8];
+  uint32_t version;
+  /// 0x01020304 in the byte order of the writer
+  uint32_t byte_order;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+  uint64_t strings_used;
+  uint64_t ring_offset;
+  uint64_t ring_size;
+  /// Offset in the ring where the next record is written
+  uint64_t head;
+  /// Offset in the ring of the oldest record
+  uint64_t tail;
+  /// Bytes of the ring between tail and head
+  uint64_t used;
+  /// Number of records written since the file was created
+  uint64_t record_count;
+} rclpy_binary_log_header_t;
+
+/// String entry defining the id of a logger name or a location
+/**
+ * Followed by the NUL-terminated logger name, or function name and file name.
+ */
+typedef struct
+{
+  /// Size of the entry including the strings, a multiple of 8
+  uint32_t size;
+  uint32_t id;
+  uint32_t kind;
+  uint32_t line_number;
+} rclpy_binary_log_entry_t;
+
+/// Record of a log message, followed by the message without NUL terminator
+typedef struct
+{
+  /// Size of the record including the message, a multiple of 8, or 0 if the rest of the ring is
+  /// unused
+  uint32_t size;
+  /// Id of the logger name, 0 if unknown
+  uint32_t name_id;
+  /// Id of the location, 0 if unknown
+  uint32_t location_id;
+  uint16_t severity;
+  uint16_t message_size;
+  int64_t timestamp;
+} rclpy_binary_log_record_t;
+
+/// Entry of a hash table interning strings to ids
+typedef struct
+{
+  uint64_t hash;
+  uint32_t id;
+  char * key;
+  size_t key_size;
+} rclpy_intern_entry_t;
+
+/// Open addressing hash table interning strings to ids
+typedef struct
+{
+  rclpy_intern_entry_t * entries;
+  size_t capacity;
+  size_t size;
+} rclpy_intern_table_t;
+
+/// State of binary log output
+/**
+ * The output handler can be called from any thread, with or without the GIL, so everything is
+ * protected by `lock`.
+ */
+typedef struct
+{
+  bool enabled;
+  /// True while the file is opened by enable_binary_output, which releases the GIL meanwhile
+  bool opening;
+  PyThread_type_lock lock;
+  rcutils_logging_output_handler_t previous_output_handler;
+#ifdef _WIN32
+  HANDLE file;
+  HANDLE mapping;
+#else
+  int fd;
+#endif
+  size_t size;
+  char * data;
+  rclpy_binary_log_header_t * header;
+  rclpy_intern_table_t logger_names;
+  rclpy_intern_table_t locations;
+  uint32_t next_id;
+} rclpy_binary_log_t;
+
+static rclpy_binary_log_t g_binary_log;
+
+#ifdef _MSC_VER
+# define RCLPY_COMPILER_BARRIER() _ReadWriteBarrier()
+#else
+# define RCLPY_COMPILER_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+#endif
+
+static size_t
+_align8(size_t size)
+{
+  return (size + 7) & ~(size_t)7;
+}
+
+/// FNV-1a hash
+static uint64_t
+_hash_bytes(const char * data, size_t size)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= (unsigned char)data[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static void
+_intern_table_fini(rclpy_intern_table_t * table)
+{
+  for (size_t i = 0; i < table->capacity; ++i) {
+    PyMem_RawFree(table->entries[i].key);
+  }
+  PyMem_RawFree(table->entries);
+  memset(table, 0, sizeof(rclpy_intern_table_t));
+}
+
+/// Find the slot of a key in an interning table, which is empty if the key is not interned
+static rclpy_intern_entry_t *
+_intern_table_find(
+  rclpy_intern_table_t * table, uint64_t hash, const char * key, size_t key_size)
+{
+  size_t mask = table->capacity - 1;
+  for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask) {
+    rclpy_intern_entry_t * entry = &table->entries[i];
+    if (NULL == entry->key ||
+      (entry->hash == hash && entry->key_size == key_size &&
+      0 == memcmp(entry->key, key, key_size)))
+    {
+      return entry;
+    }
+  }
+}
+
+/// Add a key to an interning table
+/**
+ * \return false if memory ran out
+ */
+static bool
+_intern_table_add(
+  rclpy_intern_table_t * table, uint64_t hash, const char * key, size_t key_size, uint32_t id)
+{
+  if (2 * (table->size + 1) > table->capacity) {
+    rclpy_intern_table_t grown;
+    grown.capacity = table->capacity ? 2 * table->capacity : 64;
+    grown.size = table->size;
+    grown.entries = (rclpy_intern_entry_t *)PyMem_RawCalloc(
+      grown.capacity, sizeof(rclpy_intern_entry_t));
+    if (NULL == grown.entries) {
+      return false;
+    }
+    for (size_t i = 0; i < table->capacity; ++i) {
+      rclpy_intern_entry_t * entry = &table->entries[i];
+      if (NULL != entry->key) {
+        *_intern_table_find(&grown, entry->hash, entry->key, entry->key_size) = *entry;
+      }
+    }
+    PyMem_RawFree(table->entries);
+    *table = grown;
+  }
+  char * key_copy = (char *)PyMem_RawMalloc(key_size);
+  if (NULL == key_copy) {
+    return false;
+  }
+  memcpy(key_copy, key, key_size);
+  rclpy_intern_entry_t * entry = _intern_table_find(table, hash, key, key_size);
+  entry->hash = hash;
+  entry->id = id;
+  entry->key = key_copy;
+  entry->key_size = key_size;
+  table->size++;
+  return true;
+}
+
+/// Get the id of a logger name or location, writing its string entry the first time
+/**
+ * \param[in] key Bytes identifying the name or location
+ * \param[in] strings NUL-terminated strings of the entry, concatenated
+ * \return the id, or 0 if the strings region is full or memory ran out
+ */
+static uint32_t
+_binary_log_intern(
+  rclpy_binary_log_t * binary_log, rclpy_intern_table_t * table, const char * key,
+  size_t key_size, uint32_t kind, const char * strings, size_t strings_size, size_t line_number)
+{
+  uint64_t hash = _hash_bytes(key, key_size);
+  if (table->capacity > 0) {
+    rclpy_intern_entry_t * entry = _intern_table_find(table, hash, key, key_size);
+    if (NULL != entry->key) {
+      return entry->id;
+    }
+  }
+
+  rclpy_binary_log_header_t * header = binary_log->header;
+  size_t entry_size = _align8(sizeof(rclpy_binary_log_entry_t) + strings_size);
+  if (header->strings_used + entry_size > header->strings_size) {
+    return 0;
+  }
+  uint32_t id = binary_log->next_id;
+  if (!_intern_table_add(table, hash, key, key_size, id)) {
+    return 0;
+  }
+  binary_log->next_id++;
+
+  char * data = binary_log->data + header->strings_offset + header->strings_used;
+  rclpy_binary_log_entry_t entry_header = {
+    (uint32_t)entry_size, id, kind, (uint32_t)line_number};
+  memcpy(data, &entry_header, sizeof(entry_header));
+  memcpy(data + sizeof(entry_header), strings, strings_size);
+  RCLPY_COMPILER_BARRIER();
+  header->strings_used += entry_size;
+  return id;
+}
+
+/// Remove the oldest record from the ring
+static void
+_binary_log_drop_oldest(rclpy_binary_log_header_t * header, const char * ring)
+{
+  uint32_t size;
+  memcpy(&size, ring + header->tail, sizeof(size));
+  if (0 == size) {
+    // Unused end of the ring
+    size = (uint32_t)(header->ring_size - header->tail);
+  }
+  header->tail += size;
+  if (header->tail == header->ring_size) {
+    header->tail = 0;
+  }
+  header->used -= size;
+}
+
+/// Output handler writing binary records to the mapped file
+static void
+_binary_log_output_handler(
+  const rcutils_log_location_t * location, int severity, const char * name,
+  rcutils_time_point_value_t timestamp, const char * format, va_list * args)
+{
+  rclpy_binary_log_t * binary_log = &g_binary_log;
+  char message[RCLPY_BINARY_LOG_MAX_MESSAGE_SIZE];
+  va_list args_copy;
+  va_copy(args_copy, *args);
+  int formatted_size = vsnprintf(message, sizeof(message), format, args_copy);
+  va_end(args_copy);
+  size_t message_size = 0;
+  if (formatted_size > 0) {
+    message_size = (size_t)formatted_size < sizeof(message) ?
+      (size_t)formatted_size : sizeof(message) - 1;
+  }
+
+  PyThread_acquire_lock(binary_log->lock, WAIT_LOCK);
+  if (!binary_log->enabled) {
+    PyThread_release_lock(binary_log->lock);
+    return;
+  }
+  rclpy_binary_log_header_t * header = binary_log->header;
+
+  size_t name_size = strlen(name) + 1;
+  uint32_t name_id = _binary_log_intern(
+    binary_log, &binary_log->logger_names, name, name_size, RCLPY_BINARY_LOG_ENTRY_LOGGER_NAME,
+    name, name_size, 0);
+  uint32_t location_id = 0;
+  if (NULL != location) {
+    // The key and the strings of the entry are the function name and the file name, the key
+    // also has the line number
+    char strings[1024];
+    int strings_size = snprintf(
+      strings, sizeof(strings), "%s%c%s%c%zu", location->function_name, '\0',
+      location->file_name, '\0', location->line_number);
+    if (strings_size > 0 && (size_t)strings_size < sizeof(strings)) {
+      size_t key_size = (size_t)strings_size;
+      size_t entry_strings_size = strlen(location->function_name) + 1 +
+        strlen(location->file_name) + 1;
+      location_id = _binary_log_intern(
+        binary_log, &binary_log->locations, strings, key_size, RCLPY_BINARY_LOG_ENTRY_LOCATION,
+        strings, entry_strings_size, location->line_number);
+    }
+  }
+
+  char * ring = binary_log->data + header->ring_offset;
+  size_t record_size = _align8(sizeof(rclpy_binary_log_record_t) + message_size);
+  if (header->ring_size - header->head < record_size) {
+    // Mark the end of the ring unused and continue at its start
+    size_t unused = header->ring_size - header->head;
+    while (header->ring_size - header->used < unused) {
+      _binary_log_drop_oldest(header, ring);
+    }
+    uint32_t end_marker = 0;
+    memcpy(ring + header->head, &end_marker, sizeof(end_marker));
+    RCLPY_COMPILER_BARRIER();
+    header->used += unused;
+    header->head = 0;
+  }
+  while (header->ring_size - header->used < record_size) {
+    _binary_log_drop_oldest(header, ring);
+  }
+
+  rclpy_binary_log_record_t record = {
+    (uint32_t)record_size, name_id, location_id, (uint16_t)severity, (uint16_t)message_size,
+    timestamp};
+  memcpy(ring + header->head, &record, sizeof(record));
+  memcpy(ring + header->head + sizeof(record), message, message_size);
+  RCLPY_COMPILER_BARRIER();
+  header->head += record_size;
+  if (header->head == header->ring_size) {
+    header->head = 0;
+  }
+  header->used += record_size;
+  header->record_count++;
+  PyThread_release_lock(binary_log->lock);
+}
+
+/// Unmap and close the binary log file, with the lock held or before it is used
+static void
+_binary_log_close(rclpy_binary_log_t * binary_log)
+{
+#ifdef _WIN32
+  if (NULL != binary_log->data) {
+    UnmapViewOfFile(binary_log->data);
+  }
+  if (NULL != binary_log->mapping) {
+    CloseHandle(binary_log->mapping);
+  }
+  if (INVALID_HANDLE_VALUE != binary_log->file && NULL != binary_log->file) {
+    CloseHandle(binary_log->file);
+  }
+  binary_log->file = NULL;
+  binary_log->mapping = NULL;
+#else
+  if (NULL != binary_log->data) {
+    munmap(binary_log->data, binary_log->size);
+  }
+  if (binary_log->fd >= 0) {
+    close(binary_log->fd);
+  }
+  binary_log->fd = -1;
+#endif
+  binary_log->data = NULL;
+  binary_log->header = NULL;
+  _intern_table_fini(&binary_log->logger_names);
+  _intern_table_fini(&binary_log->locations);
+}
+
+/// Create the binary log file and map it in memory
+/**
+ * \return false with errno or the last error set on failure
+ */
+static bool
+_binary_log_open(rclpy_binary_log_t * binary_log, const char * path, size_t size)
+{
+  binary_log->size = size;
+#ifdef _WIN32
+  binary_log->file = CreateFileA(
+    path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+    FILE_ATTRIBUTE_NORMAL, NULL);
+  if (INVALID_HANDLE_VALUE == binary_log->file) {
+    return false;
+  }
+  binary_log->mapping = CreateFileMappingA(
+    binary_log->file, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32),
+    (DWORD)(size & 0xFFFFFFFF), NULL);
+  if (NULL == binary_log->mapping) {
+    return false;
+  }
+  binary_log->data = (char *)MapViewOfFile(binary_log->mapping, FILE_MAP_WRITE, 0, 0, size);
+  if (NULL == binary_log->data) {
+    return false;
+  }
+#else
+  binary_log->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (binary_log->fd < 0) {
+    return false;
+  }
+  if (0 != ftruncate(binary_log->fd, (off_t)size)) {
+    return false;
+  }
+  void * data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, binary_log->fd, 0);
+  if (MAP_FAILED == data) {
+    return false;
+  }
+  binary_log->data = (char *)data;
+#endif
+  return true;
+}
+
+/// Stop writing log messages to the binary log file
+static void
+_binary_log_disable(rclpy_binary_log_t * binary_log)
+{
+  if (!binary_log->enabled) {
+    return;
+  }
+  rcutils_logging_set_output_handler(binary_log->previous_output_handler);
+  PyThread_acquire_lock(binary_log->lock, WAIT_LOCK);
+  binary_log->enabled = false;
+  _binary_log_close(binary_log);
+  PyThread_release_lock(binary_log->lock);
+}
+
 /// Initialize the logging system.
 /**
  * \return None or
  * \return NULL on failure
  */
 static PyObject *
-rclpy_logging_initialize(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
+rclpy_logging_initialize(PyObject * self, PyObject * Py_UNUSED(args))
 {
   rcutils_ret_t ret = rcutils_logging_initialize();
   if (ret != RCUTILS_RET_OK) {
@@ -33,17 +733,33 @@ rclpy_logging_initialize(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
     rcutils_reset_error();
     return NULL;
   }
+  if (0 != _bump_logger_level_generation(self)) {
+    return NULL;
+  }
+  rclpy_binary_log_t * binary_log = &g_binary_log;
+  if (binary_log->enabled) {
+    // Initializing rcutils again resets its output handler
+    rcutils_logging_output_handler_t output_handler = rcutils_logging_get_output_handler();
+    if (output_handler != _binary_log_output_handler) {
+      binary_log->previous_output_handler = output_handler;
+      rcutils_logging_set_output_handler(_binary_log_output_handler);
+    }
+  }
   Py_RETURN_NONE;
 }
 
 /// Shutdown the logging system.
 /**
+ * Records queued for asynchronous logging are written first, and binary output is disabled.
+ *
  * \return None or
  * \return NULL on failure
  */
 static PyObject *
-rclpy_logging_shutdown(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
+rclpy_logging_shutdown(PyObject * self, PyObject * Py_UNUSED(args))
 {
+  _async_logging_stop(&g_async_logging);
+  _binary_log_disable(&g_binary_log);
   // TODO(dhood): error checking
   rcutils_ret_t ret = rcutils_logging_shutdown();
   if (ret != RCUTILS_RET_OK) {
@@ -52,11 +768,17 @@ rclpy_logging_shutdown(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
     rcutils_reset_error();
     return NULL;
   }
+  // Shutting down forgets the logger levels
+  if (0 != _bump_logger_level_generation(self)) {
+    return NULL;
+  }
   Py_RETURN_NONE;
 }
 
 /// Set the level of a logger.
 /**
+ * Changing the level of a logger can change the effective level of its descendants, so this
+ * invalidates the levels cached by all rclpy loggers.
  *
  * \param[in] name Fully-qualified name of logger.
  * \param[in] level to set
@@ -64,7 +786,7 @@ rclpy_logging_shutdown(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
  * \return NULL on failure
  */
 static PyObject *
-rclpy_logging_set_logger_level(PyObject * Py_UNUSED(self), PyObject * args)
+rclpy_logging_set_logger_level(PyObject * self, PyObject * args)
 {
   const char * name;
   int level;
@@ -80,6 +802,9 @@ rclpy_logging_set_logger_level(PyObject * Py_UNUSED(self), PyObject * args)
     rcutils_reset_error();
     return NULL;
   }
+  if (0 != _bump_logger_level_generation(self)) {
+    return NULL;
+  }
   Py_RETURN_NONE;
 }
 
@@ -164,11 +889,507 @@ rclpy_logging_rcutils_log(PyObject * Py_UNUSED(self), PyObject * args)
   }
 
   RCUTILS_LOGGING_AUTOINIT
+  if (g_async_logging.running) {
+    // rcutils_log does the same check before calling the output handler
+    if (!rcutils_logging_logger_is_enabled_for(name, severity)) {
+      Py_RETURN_NONE;
+    }
+    _async_logging_push(
+      &g_async_logging, severity, name, message, function_name, file_name, line_number);
+    Py_RETURN_NONE;
+  }
   rcutils_log_location_t logging_location = {function_name, file_name, line_number};
   rcutils_log(&logging_location, severity, name, message);
   Py_RETURN_NONE;
 }
 
+/// Write log messages from a background thread instead of the logging thread.
+/**
+ * Raises RuntimeError if asynchronous logging is already enabled or being disabled, or the
+ *   thread fails to start
+ * Raises ValueError if capacity is 0
+ *
+ * \param[in] capacity Maximum number of records waiting to be written, further records are
+ *   dropped.
+ * \return None or
+ * \return NULL on failure
+ */
+static PyObject *
+rclpy_logging_enable_async(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  Py_ssize_t capacity;
+  if (!PyArg_ParseTuple(args, "n", &capacity)) {
+    return NULL;
+  }
+  rclpy_async_logging_t * async_logging = &g_async_logging;
+  if (async_logging->running) {
+    PyErr_Format(PyExc_RuntimeError, "Asynchronous logging is already enabled");
+    return NULL;
+  }
+  if (async_logging->stopping) {
+    PyErr_Format(PyExc_RuntimeError, "Asynchronous logging is being disabled");
+    return NULL;
+  }
+  if (capacity < 1) {
+    PyErr_Format(PyExc_ValueError, "Asynchronous logging capacity must be at least 1");
+    return NULL;
+  }
+
+  async_logging->capacity = (size_t)capacity;
+  async_logging->records =
+    (rclpy_log_record_t **)PyMem_Calloc(async_logging->capacity, sizeof(rclpy_log_record_t *));
+  async_logging->batch =
+    (rclpy_log_record_t **)PyMem_Calloc(async_logging->capacity, sizeof(rclpy_log_record_t *));
+  async_logging->lock = PyThread_allocate_lock();
+  async_logging->records_event = PyThread_allocate_lock();
+  async_logging->done_event = PyThread_allocate_lock();
+  if (!async_logging->records || !async_logging->batch || !async_logging->lock ||
+    !async_logging->records_event || !async_logging->done_event)
+  {
+    _async_logging_fini(async_logging);
+    return PyErr_NoMemory();
+  }
+  // Events start unsignaled
+  PyThread_acquire_lock(async_logging->records_event, WAIT_LOCK);
+  PyThread_acquire_lock(async_logging->done_event, WAIT_LOCK);
+
+  async_logging->running = true;
+  if (PyThread_start_new_thread(_async_logging_thread, NULL) == (unsigned long)-1) {
+    async_logging->running = false;
+    _async_logging_fini(async_logging);
+    PyErr_Format(PyExc_RuntimeError, "Failed to start the asynchronous logging thread");
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+/// Write the queued log records and go back to writing from the logging thread.
+/**
+ * Does nothing if asynchronous logging is not enabled, waits until it is disabled if another
+ * thread is disabling it.
+ *
+ * \return None
+ */
+static PyObject *
+rclpy_logging_disable_async(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
+{
+  _async_logging_stop(&g_async_logging);
+  Py_RETURN_NONE;
+}
+
+/// Get the counters of asynchronous logging.
+/**
+ * The counters are kept when asynchronous logging is disabled and enabled again.
+ *
+ * \return dict with the number of records `queued`, `written` and `dropped` because the buffer
+ *   was full, or
+ * \return NULL on failure
+ */
+static PyObject *
+rclpy_logging_get_async_stats(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
+{
+  rclpy_async_logging_t * async_logging = &g_async_logging;
+  // The background thread may still be writing records while stopping
+  bool running = async_logging->running || async_logging->stopping;
+  if (running) {
+    PyThread_acquire_lock(async_logging->lock, WAIT_LOCK);
+  }
+  size_t queued = async_logging->size;
+  uint64_t written = async_logging->written;
+  uint64_t dropped = async_logging->dropped;
+  if (running) {
+    PyThread_release_lock(async_logging->lock);
+  }
+  return Py_BuildValue("{s:n,s:K,s:K}",
+           "queued", (Py_ssize_t)queued,
+           "written", (unsigned PY_LONG_LONG)written,
+           "dropped", (unsigned PY_LONG_LONG)dropped);
+}
+
+#if PY_VERSION_HEX >= 0x030B0000
+# define RCLPY_FRAME_GET_LASTI(frame) PyFrame_GetLasti(frame)
+#else
+# define RCLPY_FRAME_GET_LASTI(frame) ((frame)->f_lasti)
+#endif
+
+/// Get a new reference to the code object of a frame
+static PyObject *
+_frame_get_code(PyFrameObject * frame)
+{
+#if PY_VERSION_HEX >= 0x030900B1
+  return (PyObject *)PyFrame_GetCode(frame);
+#else
+  Py_INCREF(frame->f_code);
+  return (PyObject *)frame->f_code;
+#endif
+}
+
+/// Get a new reference to the calling frame of a frame, or NULL if it is the outermost one
+static PyFrameObject *
+_frame_get_back(PyFrameObject * frame)
+{
+#if PY_VERSION_HEX >= 0x030900B1
+  return PyFrame_GetBack(frame);
+#else
+  Py_XINCREF(frame->f_back);
+  return frame->f_back;
+#endif
+}
+
+/// Sequence of file paths of modules whose frames are skipped when looking for the caller
+static PyObject * g_internal_callers = NULL;
+/// Cache of code object address -> (call site token, weak reference to the code object,
+/// function name, absolute file path, is internal)
+/**
+ * Code objects compare by value, ignoring their file, so they are looked up by address.
+ * Entries are removed when their code object is destroyed, before the address can be reused.
+ * The token is a plain object identifying the code object in call site keys: unlike the
+ * address it is never reused while a key holds it.
+ */
+static PyObject * g_code_info = NULL;
+
+enum
+{
+  RCLPY_CODE_INFO_TOKEN,
+  RCLPY_CODE_INFO_WEAKREF,
+  RCLPY_CODE_INFO_FUNCTION_NAME,
+  RCLPY_CODE_INFO_FILE_PATH,
+  RCLPY_CODE_INFO_IS_INTERNAL,
+};
+
+/// Write log messages as binary records to a memory-mapped file instead of the console.
+/**
+ * The file has a fixed size: once full, the oldest records are overwritten.
+ * Logger names and locations are written once and referred to by id.
+ * Because the file is mapped, written records survive a crash of the process without being
+ * flushed.
+ * The file can be turned back into text with `python3 -m rclpy.binary_log`.
+ *
+ * Raises RuntimeError if binary output is already enabled or being enabled
+ * Raises ValueError if size is too small
+ * Raises OSError if the file cannot be created or mapped
+ *
+ * \param[in] path Path of the file, which is overwritten
+ * \param[in] size Size of the file in bytes
+ * \return None or
+ * \return NULL on failure
+ */
+static PyObject *
+rclpy_logging_enable_binary_output(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * pypath;
+  Py_ssize_t size;
+  if (!PyArg_ParseTuple(args, "O&n", PyUnicode_FSConverter, &pypath, &size)) {
+    return NULL;
+  }
+  rclpy_binary_log_t * binary_log = &g_binary_log;
+  if (binary_log->enabled || binary_log->opening) {
+    Py_DECREF(pypath);
+    PyErr_Format(PyExc_RuntimeError, "Binary log output is already enabled");
+    return NULL;
+  }
+  if (size < RCLPY_BINARY_LOG_MIN_SIZE) {
+    Py_DECREF(pypath);
+    PyErr_Format(PyExc_ValueError, "Binary log size must be at least %d bytes",
+      RCLPY_BINARY_LOG_MIN_SIZE);
+    return NULL;
+  }
+  if (NULL == binary_log->lock) {
+    binary_log->lock = PyThread_allocate_lock();
+    if (NULL == binary_log->lock) {
+      Py_DECREF(pypath);
+      return PyErr_NoMemory();
+    }
+  }
+
+#ifndef _WIN32
+  binary_log->fd = -1;
+#endif
+  bool opened;
+  // Other threads enabling binary output fail until it is enabled or opening failed
+  binary_log->opening = true;
+  Py_BEGIN_ALLOW_THREADS;
+  opened = _binary_log_open(binary_log, PyBytes_AS_STRING(pypath), (size_t)size);
+  Py_END_ALLOW_THREADS;
+  binary_log->opening = false;
+  if (!opened) {
+#ifdef _WIN32
+    PyErr_SetExcFromWindowsErrWithFilenameObject(PyExc_OSError, GetLastError(), pypath);
+#else
+    PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, pypath);
+#endif
+    Py_DECREF(pypath);
+    _binary_log_close(binary_log);
+    return NULL;
+  }
+  Py_DECREF(pypath);
+
+  // The strings region takes an eighth of the file, the ring of records the rest
+  rclpy_binary_log_header_t * header = (rclpy_binary_log_header_t *)binary_log->data;
+  memcpy(header->magic, "RCLPYLOG", sizeof(header->magic));
+  header->version = RCLPY_BINARY_LOG_VERSION;
+  header->byte_order = 0x01020304;
+  header->strings_offset = RCLPY_BINARY_LOG_HEADER_SIZE;
+  header->strings_size = _align8(((size_t)size - RCLPY_BINARY_LOG_HEADER_SIZE) / 8);
+  header->strings_used = 0;
+  header->ring_offset = header->strings_offset + header->strings_size;
+  header->ring_size = ((size_t)size - header->ring_offset) & ~(size_t)7;
+  header->head = 0;
+  header->tail = 0;
+  header->used = 0;
+  header->record_count = 0;
+  binary_log->header = header;
+  binary_log->next_id = 1;
+
+  RCUTILS_LOGGING_AUTOINIT
+  binary_log->previous_output_handler = rcutils_logging_get_output_handler();
+  binary_log->enabled = true;
+  rcutils_logging_set_output_handler(_binary_log_output_handler);
+  Py_RETURN_NONE;
+}
+
+/// Go back to the output handler used before binary output was enabled.
+/**
+ * Does nothing if binary output is not enabled.
+ *
+ * \return None
+ */
+static PyObject *
+rclpy_logging_disable_binary_output(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
+{
+  _binary_log_disable(&g_binary_log);
+  Py_RETURN_NONE;
+}
+
+/// Set the file paths of the modules logging calls are made through.
+/**
+ * Frames of code from these files are skipped by rclpy_logging_get_caller().
+ * The sequence is kept by reference, so paths added to it later are also skipped, but only for
+ * code that has not been resolved yet.
+ *
+ * \param[in] internal_callers Sequence of real file paths, matched as substrings.
+ * \return None
+ */
+static PyObject *
+rclpy_logging_set_internal_callers(PyObject * Py_UNUSED(self), PyObject * args)
+{
+  PyObject * internal_callers;
+  if (!PyArg_ParseTuple(args, "O", &internal_callers)) {
+    return NULL;
+  }
+  Py_INCREF(internal_callers);
+  Py_XSETREF(g_internal_callers, internal_callers);
+  if (NULL != g_code_info) {
+    PyDict_Clear(g_code_info);
+  }
+  Py_RETURN_NONE;
+}
+
+/// Check if a weak reference refers to an object.
+static bool
+_weakref_refers_to(PyObject * weakref, PyObject * object)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+  PyObject * referent = NULL;
+  if (PyWeakref_GetRef(weakref, &referent) < 0) {
+    PyErr_Clear();
+    return false;
+  }
+  Py_XDECREF(referent);
+  return referent == object;
+#else
+  return PyWeakref_GET_OBJECT(weakref) == object;
+#endif
+}
+
+/// Remove the cache entry of a destroyed code object.
+/**
+ * Called by the weak reference to the code object.
+ *
+ * \param[in] key Address of the code object, the key of the entry.
+ * \param[in] weakref The weak reference of the entry.
+ * \return None
+ */
+static PyObject *
+_forget_code_info(PyObject * key, PyObject * weakref)
+{
+  if (NULL != g_code_info) {
+    PyObject * code_info = PyDict_GetItem(g_code_info, key);
+    if (NULL != code_info && weakref == PyTuple_GET_ITEM(code_info, RCLPY_CODE_INFO_WEAKREF)) {
+      if (PyDict_DelItem(g_code_info, key)) {
+        return NULL;
+      }
+    }
+  }
+  Py_RETURN_NONE;
+}
+
+static PyMethodDef g_forget_code_info_def = {
+  "_forget_code_info", _forget_code_info, METH_O, NULL
+};
+
+/// Resolve the function name and file path of a code object.
+/**
+ * The file paths are resolved with os.path once per code object.
+ *
+ * \param[in] code Code object of a frame.
+ * \return Borrowed reference to the cache entry of the code object, see g_code_info, or
+ * \return NULL on failure.
+ */
+static PyObject *
+_get_code_info(PyObject * code)
+{
+  if (NULL == g_code_info) {
+    g_code_info = PyDict_New();
+    if (NULL == g_code_info) {
+      return NULL;
+    }
+  }
+  PyObject * key = PyLong_FromVoidPtr(code);
+  if (NULL == key) {
+    return NULL;
+  }
+  PyObject * code_info = PyDict_GetItem(g_code_info, key);
+  if (NULL != code_info &&
+    _weakref_refers_to(PyTuple_GET_ITEM(code_info, RCLPY_CODE_INFO_WEAKREF), code))
+  {
+    Py_DECREF(key);
+    return code_info;
+  }
+
+  PyObject * function_name = PyObject_GetAttrString(code, "co_name");
+  if (NULL == function_name) {
+    Py_DECREF(key);
+    return NULL;
+  }
+  PyObject * file_name = PyObject_GetAttrString(code, "co_filename");
+  if (NULL == file_name) {
+    Py_DECREF(function_name);
+    Py_DECREF(key);
+    return NULL;
+  }
+  PyObject * os_path = PyImport_ImportModule("os.path");
+  if (NULL == os_path) {
+    Py_DECREF(function_name);
+    Py_DECREF(file_name);
+    Py_DECREF(key);
+    return NULL;
+  }
+  PyObject * file_path = PyObject_CallMethod(os_path, "abspath", "O", file_name);
+  // Note: realpath also resolves mixed slashes that can result on Windows.
+  PyObject * real_path = PyObject_CallMethod(os_path, "realpath", "O", file_name);
+  Py_DECREF(os_path);
+  Py_DECREF(file_name);
+  if (NULL == file_path || NULL == real_path) {
+    Py_DECREF(function_name);
+    Py_XDECREF(file_path);
+    Py_XDECREF(real_path);
+    Py_DECREF(key);
+    return NULL;
+  }
+
+  int is_internal = 0;
+  if (NULL != g_internal_callers) {
+    PyObject * iterator = PyObject_GetIter(g_internal_callers);
+    PyObject * internal_caller;
+    while (NULL != iterator && !is_internal && (internal_caller = PyIter_Next(iterator))) {
+      is_internal = PySequence_Contains(real_path, internal_caller);
+      Py_DECREF(internal_caller);
+    }
+    Py_XDECREF(iterator);
+    if (is_internal < 0 || PyErr_Occurred()) {
+      Py_DECREF(function_name);
+      Py_DECREF(file_path);
+      Py_DECREF(real_path);
+      Py_DECREF(key);
+      return NULL;
+    }
+  }
+  Py_DECREF(real_path);
+
+  PyObject * token = PyObject_CallObject((PyObject *)&PyBaseObject_Type, NULL);
+  PyObject * forget = PyCFunction_New(&g_forget_code_info_def, key);
+  PyObject * weakref = NULL;
+  if (NULL != forget) {
+    weakref = PyWeakref_NewRef(code, forget);
+    Py_DECREF(forget);
+  }
+  if (NULL == token || NULL == weakref) {
+    Py_DECREF(function_name);
+    Py_DECREF(file_path);
+    Py_XDECREF(token);
+    Py_XDECREF(weakref);
+    Py_DECREF(key);
+    return NULL;
+  }
+  code_info = Py_BuildValue(
+    "(NNNNO)", token, weakref, function_name, file_path, is_internal ? Py_True : Py_False);
+  if (NULL == code_info) {
+    Py_DECREF(key);
+    return NULL;
+  }
+  int ret = PyDict_SetItem(g_code_info, key, code_info);
+  Py_DECREF(key);
+  // The dictionary holds a reference
+  Py_DECREF(code_info);
+  if (0 != ret) {
+    return NULL;
+  }
+  return code_info;
+}
+
+/// Find the first calling frame that is outside of the internal callers.
+/**
+ * Unlike inspect.getframeinfo(), this does not read source files, and file paths are only
+ * resolved the first time code is seen.
+ *
+ * \return A ((code token, instruction offset), function name, file path, line number) tuple
+ *   where the first item identifies the call site, or
+ * \return NULL on failure
+ */
+static PyObject *
+rclpy_logging_get_caller(PyObject * Py_UNUSED(self), PyObject * Py_UNUSED(args))
+{
+  PyFrameObject * frame = PyEval_GetFrame();
+  if (NULL == frame) {
+    PyErr_Format(PyExc_RuntimeError, "No Python frame to find the caller from");
+    return NULL;
+  }
+  Py_INCREF(frame);
+
+  PyObject * code = NULL;
+  PyObject * code_info = NULL;
+  while (1) {
+    code = _frame_get_code(frame);
+    code_info = _get_code_info(code);
+    if (NULL == code_info) {
+      Py_DECREF(code);
+      Py_DECREF(frame);
+      return NULL;
+    }
+    if (Py_True != PyTuple_GET_ITEM(code_info, RCLPY_CODE_INFO_IS_INTERNAL)) {
+      break;
+    }
+    PyFrameObject * back = _frame_get_back(frame);
+    if (NULL == back) {
+      // Only internal frames: report the outermost one
+      break;
+    }
+    Py_DECREF(code);
+    Py_DECREF(frame);
+    frame = back;
+  }
+
+  PyObject * caller = Py_BuildValue("((Oi)OOi)",
+      PyTuple_GET_ITEM(code_info, RCLPY_CODE_INFO_TOKEN), RCLPY_FRAME_GET_LASTI(frame),
+      PyTuple_GET_ITEM(code_info, RCLPY_CODE_INFO_FUNCTION_NAME),
+      PyTuple_GET_ITEM(code_info, RCLPY_CODE_INFO_FILE_PATH),
+      PyFrame_GetLineNumber(frame));
+  Py_DECREF(code);
+  Py_DECREF(frame);
+  return caller;
+}
+
 /// Define the public methods of this module
 static PyMethodDef rclpy_logging_methods[] = {
   {
@@ -196,6 +1417,34 @@ static PyMethodDef rclpy_logging_methods[] = {
     "rclpy_logging_rcutils_log", rclpy_logging_rcutils_log, METH_VARARGS,
     "Log a message with the specified severity"
   },
+  {
+    "rclpy_logging_enable_async", rclpy_logging_enable_async, METH_VARARGS,
+    "Write log messages from a background thread."
+  },
+  {
+    "rclpy_logging_disable_async", rclpy_logging_disable_async, METH_NOARGS,
+    "Write the queued log messages and stop the background thread."
+  },
+  {
+    "rclpy_logging_get_async_stats", rclpy_logging_get_async_stats, METH_NOARGS,
+    "Get the counters of asynchronous logging."
+  },
+  {
+    "rclpy_logging_enable_binary_output", rclpy_logging_enable_binary_output, METH_VARARGS,
+    "Write log messages as binary records to a memory-mapped file."
+  },
+  {
+    "rclpy_logging_disable_binary_output", rclpy_logging_disable_binary_output, METH_NOARGS,
+    "Stop writing log messages to the binary log file."
+  },
+  {
+    "rclpy_logging_set_internal_callers", rclpy_logging_set_internal_callers, METH_VARARGS,
+    "Set the file paths of the modules logging calls are made through."
+  },
+  {
+    "rclpy_logging_get_caller", rclpy_logging_get_caller, METH_NOARGS,
+    "Find the first calling frame that is outside of the internal callers."
+  },
 
   {NULL, NULL, 0, NULL}  /* sentinel */
 };
@@ -219,5 +1468,20 @@ static struct PyModuleDef _rclpy_logging_module = {
 /// Init function of this module
 PyMODINIT_FUNC PyInit__rclpy_logging(void)
 {
-  return PyModule_Create(&_rclpy_logging_module);
+  PyObject * module = PyModule_Create(&_rclpy_logging_module);
+  if (NULL == module) {
+    return NULL;
+  }
+  if (0 != _bump_logger_level_generation(module)) {
+    Py_DECREF(module);
+    return NULL;
+  }
+  if (!g_async_logging_stop_lock) {
+    g_async_logging_stop_lock = PyThread_allocate_lock();
+    if (!g_async_logging_stop_lock) {
+      Py_DECREF(module);
+      return PyErr_NoMemory();
+    }
+  }
+  return module;
 }
@@ -12,15 +12,19 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import ctypes
+import threading
 import time
 import unittest
+from unittest.mock import patch
 
 from rcl_interfaces.srv import GetParameters
 import rclpy
 import rclpy.executors
+from rclpy.impl.implementation_singleton import rclpy_implementation as _rclpy
 
 
-# TODO(sloretz) Reduce fudge once wait_for_service uses node graph events
+# Allowance for discovery and scheduling delays
 TIME_FUDGE = 0.3
 
 
@@ -72,6 +76,61 @@ class TestClient(unittest.TestCase):
             self.node.destroy_client(cli)
             self.node.destroy_service(srv)
 
+    def test_wait_for_service_created_later(self):
+        cli = self.node.create_client(GetParameters, 'test_wfs_later')
+        srvs = []
+        timer = threading.Timer(0.5, lambda: srvs.append(self.node.create_service(
+            GetParameters, 'test_wfs_later', lambda request, response: response)))
+        try:
+            start = time.monotonic()
+            timer.start()
+            self.assertTrue(cli.wait_for_service(timeout_sec=5.0))
+            end = time.monotonic()
+            self.assertLess(end - start, 0.5 + TIME_FUDGE)
+        finally:
+            timer.join()
+            self.node.destroy_client(cli)
+            for srv in srvs:
+                self.node.destroy_service(srv)
+
+    def test_concurrent_wait_for_service(self):
+        clis = [
+            self.node.create_client(GetParameters, 'test_wfs_concurrent_{}'.format(i))
+            for i in range(4)]
+        srvs = []
+
+        def create_services():
+            for i in range(len(clis)):
+                srvs.append(self.node.create_service(
+                    GetParameters, 'test_wfs_concurrent_{}'.format(i),
+                    lambda request, response: response))
+
+        results = [None] * len(clis)
+        durations = [None] * len(clis)
+
+        def wait(i):
+            start = time.monotonic()
+            results[i] = clis[i].wait_for_service(timeout_sec=5.0)
+            durations[i] = time.monotonic() - start
+
+        timer = threading.Timer(0.5, create_services)
+        wait_threads = [threading.Thread(target=wait, args=(i,)) for i in range(len(clis))]
+        try:
+            timer.start()
+            for thread in wait_threads:
+                thread.start()
+            for thread in wait_threads:
+                thread.join()
+            self.assertEqual([True] * len(clis), results)
+            for duration in durations:
+                self.assertLess(duration, 0.5 + TIME_FUDGE)
+        finally:
+            timer.join()
+            for cli in clis:
+                self.node.destroy_client(cli)
+            for srv in srvs:
+                self.node.destroy_service(srv)
+
     def test_concurrent_calls_to_service(self):
         cli = self.node.create_client(GetParameters, 'get/parameters')
         srv = self.node.create_service(
@@ -90,6 +149,301 @@ class TestClient(unittest.TestCase):
             self.node.destroy_client(cli)
             self.node.destroy_service(srv)
 
+    def test_call_timeout(self):
+        cli = self.node.create_client(GetParameters, 'test_call_timeout')
+        try:
+            start = time.monotonic()
+            with self.assertRaises(TimeoutError):
+                cli.call(GetParameters.Request(), timeout_sec=0.5)
+            end = time.monotonic()
+            self.assertGreater(0.5, end - start - TIME_FUDGE)
+            self.assertLess(0.5, end - start + TIME_FUDGE)
+            self.assertFalse(cli._pending_requests)
+        finally:
+            self.node.destroy_client(cli)
+
+    def test_call_while_spinning(self):
+        cli = self.node.create_client(GetParameters, 'test_call_spinning')
+        srv = self.node.create_service(
+            GetParameters, 'test_call_spinning',
+            lambda request, response: response)
+        executor = rclpy.executors.SingleThreadedExecutor(context=self.context)
+        executor.add_node(self.node)
+        stop = threading.Event()
+
+        def spin():
+            while not stop.is_set():
+                executor.spin_once(timeout_sec=0.1)
+
+        spin_thread = threading.Thread(target=spin)
+        spin_thread.start()
+        try:
+            self.assertTrue(cli.wait_for_service(timeout_sec=20))
+            for _ in range(20):
+                self.assertIsInstance(
+                    cli.call(GetParameters.Request(), timeout_sec=5.0), GetParameters.Response)
+            self.assertFalse(cli._pending_requests)
+        finally:
+            stop.set()
+            spin_thread.join()
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_client(cli)
+            self.node.destroy_service(srv)
+
+    def test_call_latency_with_multi_threaded_executor(self):
+        cli = self.node.create_client(GetParameters, 'test_call_latency')
+        srv = self.node.create_service(
+            GetParameters, 'test_call_latency',
+            lambda request, response: response)
+        executor = rclpy.executors.MultiThreadedExecutor(context=self.context)
+        executor.add_node(self.node)
+        stop = threading.Event()
+
+        def spin():
+            while not stop.is_set():
+                executor.spin_once(timeout_sec=0.1)
+
+        spin_thread = threading.Thread(target=spin)
+        spin_thread.start()
+        try:
+            self.assertTrue(cli.wait_for_service(timeout_sec=20))
+            # The calling thread is woken up when the executor takes the response, not once it
+            # ran the done callbacks of the future
+            self.assertIsInstance(cli.call(GetParameters.Request(), timeout_sec=5.0),
+                                  GetParameters.Response)
+            durations = []
+            for _ in range(20):
+                start = time.monotonic()
+                cli.call(GetParameters.Request(), timeout_sec=5.0)
+                durations.append(time.monotonic() - start)
+            self.assertLess(sorted(durations)[len(durations) // 2], TIME_FUDGE / 3)
+            self.assertLess(max(durations), TIME_FUDGE)
+            self.assertFalse(cli._sync_waiters)
+        finally:
+            stop.set()
+            spin_thread.join()
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_client(cli)
+            self.node.destroy_service(srv)
+
+    def test_concurrent_calls_without_executor(self):
+        # The responses are taken by the calling threads, one of them waiting at a time
+        self.assertIsNone(self.node.executor)
+        cli = self.node.create_client(GetParameters, 'test_call_direct')
+        server_node = rclpy.create_node('TestClientServer', context=self.context)
+        srv = server_node.create_service(
+            GetParameters, 'test_call_direct',
+            lambda request, response: response)
+        executor = rclpy.executors.SingleThreadedExecutor(context=self.context)
+        executor.add_node(server_node)
+        stop = threading.Event()
+
+        def spin():
+            while not stop.is_set():
+                executor.spin_once(timeout_sec=0.1)
+
+        responses = []
+
+        def call():
+            for _ in range(10):
+                responses.append(cli.call(GetParameters.Request(), timeout_sec=5.0))
+
+        spin_thread = threading.Thread(target=spin)
+        spin_thread.start()
+        try:
+            self.assertTrue(cli.wait_for_service(timeout_sec=20))
+            call_threads = [threading.Thread(target=call) for _ in range(4)]
+            for thread in call_threads:
+                thread.start()
+            for thread in call_threads:
+                thread.join()
+            self.assertEqual(40, len(responses))
+            self.assertFalse(cli._pending_requests)
+        finally:
+            stop.set()
+            spin_thread.join()
+            executor.shutdown()
+            self.node.destroy_client(cli)
+            server_node.destroy_service(srv)
+            server_node.destroy_node()
+
+    def test_call_async_timeout(self):
+        cli = self.node.create_client(
+            GetParameters, 'test_call_async_timeout', request_timeout_sec=0.2)
+        executor = rclpy.executors.SingleThreadedExecutor(context=self.context)
+        try:
+            future1 = cli.call_async(GetParameters.Request())
+            future2 = cli.call_async(GetParameters.Request(), timeout_sec=0.5)
+            start = time.monotonic()
+            rclpy.spin_until_future_complete(self.node, future1, executor=executor)
+            self.assertIsInstance(future1.exception(), TimeoutError)
+            self.assertFalse(future2.done())
+            rclpy.spin_until_future_complete(self.node, future2, executor=executor)
+            end = time.monotonic()
+            self.assertIsInstance(future2.exception(), TimeoutError)
+            self.assertGreater(0.5, end - start - TIME_FUDGE)
+            self.assertFalse(cli._pending_requests)
+        finally:
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_client(cli)
+
+    def test_call_async_many(self):
+        cli = self.node.create_client(GetParameters, 'test_call_async_many')
+        srv = self.node.create_service(
+            GetParameters, 'test_call_async_many',
+            lambda request, response: response)
+        executor = rclpy.executors.SingleThreadedExecutor(context=self.context)
+        try:
+            self.assertTrue(cli.wait_for_service(timeout_sec=20))
+            self.assertEqual([], cli.call_async_many([]))
+            futures = cli.call_async_many([GetParameters.Request() for _ in range(50)])
+            self.assertEqual(50, len(futures))
+            for future in futures:
+                rclpy.spin_until_future_complete(self.node, future, executor=executor)
+                self.assertIsInstance(future.result(), GetParameters.Response)
+            self.assertFalse(cli._pending_requests)
+            with self.assertRaises(TypeError):
+                cli.call_async_many([GetParameters.Request(), GetParameters.Response()])
+
+            # A send failing partway keeps the futures of the requests sent before it
+            send_requests = _rclpy.rclpy_send_requests
+
+            def fail_after_two(client_handle, requests):
+                sequence_numbers, _ = send_requests(client_handle, requests[:2])
+                return sequence_numbers, 'Failed to send request 2 of 5: error'
+
+            with patch.object(_rclpy, 'rclpy_send_requests', fail_after_two):
+                futures = cli.call_async_many([GetParameters.Request() for _ in range(5)])
+            self.assertEqual(5, len(futures))
+            for future in futures[:2]:
+                rclpy.spin_until_future_complete(self.node, future, executor=executor)
+                self.assertIsInstance(future.result(), GetParameters.Response)
+            for future in futures[2:]:
+                self.assertIsInstance(future.exception(), RuntimeError)
+            self.assertFalse(cli._pending_requests)
+            with patch.object(
+                    _rclpy, 'rclpy_send_requests', return_value=([], 'Failed to send')):
+                with self.assertRaisesRegex(RuntimeError, 'Failed to send'):
+                    cli.call_async_many([GetParameters.Request()])
+        finally:
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_client(cli)
+            self.node.destroy_service(srv)
+
+    def test_request_headers_recycled(self):
+        capsule_get_pointer = ctypes.pythonapi.PyCapsule_GetPointer
+        capsule_get_pointer.restype = ctypes.c_void_p
+        capsule_get_pointer.argtypes = [ctypes.py_object, ctypes.c_char_p]
+
+        cli = self.node.create_client(GetParameters, 'test_request_headers')
+        srv = self.node.create_service(
+            GetParameters, 'test_request_headers', lambda request, response: response)
+
+        def take_requests(count):
+            for _ in range(count):
+                cli.call_async(GetParameters.Request())
+            headers = []
+            end = time.monotonic() + 5.0
+            while len(headers) < count and time.monotonic() < end:
+                request_and_header = _rclpy.rclpy_take_request(
+                    srv.service_handle, GetParameters.Request)
+                if request_and_header is None:
+                    time.sleep(0.01)
+                else:
+                    headers.append(request_and_header[1])
+            self.assertEqual(count, len(headers))
+            return {capsule_get_pointer(header, b'rmw_request_id_t') for header in headers}
+
+        try:
+            self.assertTrue(cli.wait_for_service(timeout_sec=20))
+            # The headers are released to the free list as the capsules are dropped
+            first_headers = take_requests(3)
+            self.assertEqual(3, len(first_headers))
+            self.assertEqual(first_headers, take_requests(3))
+        finally:
+            self.node.destroy_client(cli)
+            self.node.destroy_service(srv)
+
+    def test_concurrent_service(self):
+        lock = threading.Lock()
+        running = [0]
+        peak = [0]
+
+        def handler(request, response):
+            with lock:
+                running[0] += 1
+                peak[0] = max(peak[0], running[0])
+            time.sleep(0.2)
+            with lock:
+                running[0] -= 1
+            return response
+
+        cli = self.node.create_client(GetParameters, 'test_concurrent_service')
+        srv = self.node.create_service(
+            GetParameters, 'test_concurrent_service', handler, max_concurrency=4)
+        executor = rclpy.executors.SingleThreadedExecutor(context=self.context)
+        try:
+            self.assertTrue(cli.wait_for_service(timeout_sec=20))
+            start = time.monotonic()
+            futures = cli.call_async_many([GetParameters.Request() for _ in range(8)])
+            for future in futures:
+                rclpy.spin_until_future_complete(self.node, future, executor=executor)
+                self.assertIsInstance(future.result(), GetParameters.Response)
+            end = time.monotonic()
+            self.assertLess(end - start, 8 * 0.2)
+            self.assertLessEqual(peak[0], 4)
+            self.assertGreater(peak[0], 1)
+        finally:
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_client(cli)
+            self.node.destroy_service(srv)
+
+    def test_concurrent_service_stopped(self):
+        handled = []
+        cli = self.node.create_client(GetParameters, 'test_concurrent_stopped')
+        srv = self.node.create_service(
+            GetParameters, 'test_concurrent_stopped',
+            lambda request, response: handled.append(request) or response, max_concurrency=2)
+        executor = rclpy.executors.SingleThreadedExecutor(context=self.context)
+        try:
+            self.assertTrue(cli.wait_for_service(timeout_sec=20))
+            cli.call_async(GetParameters.Request())
+            requests = []
+            end = time.monotonic() + 5.0
+            while not requests and time.monotonic() < end:
+                requests = srv._take_requests()
+                time.sleep(0.01)
+            self.assertEqual(1, len(requests))
+            self.assertEqual(1, srv._in_flight)
+            # The service is stopped between taking and dispatching the request
+            srv._stop_workers()
+            self.assertFalse(srv._has_capacity())
+            srv._dispatch(requests, executor)
+            self.assertEqual(0, srv._in_flight)
+            self.assertEqual([], srv._take_requests())
+            self.assertFalse(handled)
+        finally:
+            executor.shutdown()
+            self.node.destroy_client(cli)
+            self.node.destroy_service(srv)
+
+    def test_concurrent_service_invalid(self):
+        async def coroutine(request, response):
+            return response
+
+        with self.assertRaises(ValueError):
+            self.node.create_service(
+                GetParameters, 'test_concurrent_invalid', lambda request, response: response,
+                max_concurrency=0)
+        with self.assertRaises(TypeError):
+            self.node.create_service(
+                GetParameters, 'test_concurrent_invalid', coroutine, max_concurrency=2)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -23,6 +23,8 @@ from rclpy.clock import ROSClock
 from rclpy.duration import Duration
 from rclpy.time import Time
 
+from test_msgs.msg import Builtins
+
 from .mock_compat import __name__ as _  # noqa: ignore=F401
 
 
@@ -70,6 +72,25 @@ class TestClock(unittest.TestCase):
             assert now2 > now
             now = now2
 
+    def test_clock_now_ns(self):
+        clock = Clock(clock_type=ClockType.STEADY_TIME)
+        now = clock.now()
+        now_ns = clock.now_ns()
+        assert isinstance(now_ns, int)
+        assert now_ns > now.nanoseconds
+        assert clock.now() > Time(nanoseconds=now_ns, clock_type=ClockType.STEADY_TIME)
+
+    def test_clock_stamp(self):
+        clock = ROSClock()
+        clock._set_ros_time_is_active(True)
+        clock.set_ros_time_override(Time(seconds=3, nanoseconds=5, clock_type=ClockType.ROS_TIME))
+        msgs = [Builtins(), Builtins(), Builtins()]
+        now = clock.stamp(msgs, field='time_value')
+        assert now == Time(seconds=3, nanoseconds=5, clock_type=ClockType.ROS_TIME)
+        for msg in msgs:
+            assert msg.time_value.sec == 3
+            assert msg.time_value.nanosec == 5
+
     def test_ros_time_is_active(self):
         clock = ROSClock()
         clock._set_ros_time_is_active(True)
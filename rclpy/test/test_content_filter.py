@@ -0,0 +1,62 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+from rclpy.content_filter import ContentFilter
+
+
+class TestContentFilter(unittest.TestCase):
+
+    def test_parse_comparison(self):
+        f = ContentFilter.parse("header.frame_id == 'base'")
+        self.assertEqual(('header', 'frame_id'), f.field_names)
+        self.assertEqual('==', f.op)
+        self.assertEqual('base', f.operand)
+        self.assertEqual(0, f.modulus)
+
+        f = ContentFilter.parse('float64_value>=-1.5')
+        self.assertEqual(('float64_value',), f.field_names)
+        self.assertEqual('>=', f.op)
+        self.assertEqual(-1.5, f.operand)
+
+        f = ContentFilter.parse('bool_value != True')
+        self.assertEqual('!=', f.op)
+        self.assertIs(True, f.operand)
+
+    def test_parse_modulus(self):
+        f = ContentFilter.parse('id % 10 == 3')
+        self.assertEqual(('id',), f.field_names)
+        self.assertEqual(10, f.modulus)
+        self.assertEqual(3, f.operand)
+
+    def test_parse_invalid(self):
+        with self.assertRaises(ValueError):
+            ContentFilter.parse('')
+        with self.assertRaises(ValueError):
+            ContentFilter.parse('id = 3')
+        with self.assertRaises(ValueError):
+            ContentFilter.parse('3 == id')
+        with self.assertRaises(ValueError):
+            ContentFilter.parse('id == foo')
+        with self.assertRaises(ValueError):
+            ContentFilter.parse('id == [1, 2]')
+        with self.assertRaises(ValueError):
+            ContentFilter.parse('id % 0 == 0')
+        with self.assertRaises(ValueError):
+            ContentFilter.parse('header..frame_id == 1')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -16,7 +16,9 @@ import asyncio
 import time
 import unittest
 
+import builtin_interfaces.msg
 import rclpy
+from rclpy.executors import LockstepExecutor
 from rclpy.executors import MultiThreadedExecutor
 from rclpy.executors import SingleThreadedExecutor
 
@@ -261,6 +263,66 @@ class TestExecutor(unittest.TestCase):
         assert executor.add_node(self.node)
         assert not executor.add_node(self.node)
 
+    def test_lockstep_executor(self):
+        self.assertIsNotNone(self.node.handle)
+        sim = rclpy.create_node('TestLockstepSim', namespace='/rclpy', context=self.context)
+        self.node._time_source.ros_time_is_active = True
+        clock = self.node.get_clock()
+        ticks = []
+        tmr = self.node.create_timer(1.0, lambda: ticks.append(clock.now_ns()), clock=clock)
+        reports = []
+        sim.create_subscription(
+            builtin_interfaces.msg.Time, '/rclpy/TestExecutor/step_complete', reports.append)
+        clock_pub = sim.create_publisher(builtin_interfaces.msg.Time, '/clock')
+        executor = LockstepExecutor(self.node, context=self.context)
+        try:
+            assert executor.add_node(self.node)
+            assert executor.add_node(sim)
+            for sec in range(1, 4):
+                clock_pub.publish(builtin_interfaces.msg.Time(sec=sec))
+                begin = time.monotonic()
+                while (not reports or reports[-1].sec != sec) and time.monotonic() - begin < 5:
+                    executor.spin_once(timeout_sec=0.1)
+                self.assertEqual(sec, reports[-1].sec)
+                # The timer due at this time ran before the step was reported
+                self.assertEqual([s * 1000000000 for s in range(1, sec + 1)], ticks)
+        finally:
+            executor.shutdown()
+            self.node.destroy_timer(tmr)
+            sim.destroy_node()
+
+    def test_lockstep_executor_clock_pending(self):
+        # /clock is already waiting when spinning starts, so it is handled from a zero timeout
+        # wait, and the timer it makes due must still run before the step is reported
+        sim = rclpy.create_node('TestLockstepSim', namespace='/rclpy', context=self.context)
+        self.node._time_source.ros_time_is_active = True
+        clock = self.node.get_clock()
+        ticks = []
+        tmr = self.node.create_timer(1.0, lambda: ticks.append(clock.now_ns()), clock=clock)
+        reports = []
+        sim.create_subscription(
+            builtin_interfaces.msg.Time, '/rclpy/TestExecutor/step_complete', reports.append)
+        clock_pub = sim.create_publisher(builtin_interfaces.msg.Time, '/clock')
+        executor = LockstepExecutor(self.node, context=self.context)
+        try:
+            assert executor.add_node(self.node)
+            assert executor.add_node(sim)
+            publishers = len(self.node.publishers)
+            for sec in range(1, 4):
+                clock_pub.publish(builtin_interfaces.msg.Time(sec=sec))
+                time.sleep(0.5)
+                begin = time.monotonic()
+                while (not reports or reports[-1].sec != sec) and time.monotonic() - begin < 5:
+                    executor.spin_once(timeout_sec=0.1)
+                self.assertEqual(sec, reports[-1].sec)
+                self.assertEqual([s * 1000000000 for s in range(1, sec + 1)], ticks)
+        finally:
+            self.assertTrue(executor.shutdown())
+            self.node.destroy_timer(tmr)
+            sim.destroy_node()
+        # The publisher of the reports is destroyed with the executor
+        self.assertEqual(publishers - 1, len(self.node.publishers))
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -12,11 +12,21 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import gc
 import inspect
+import os
+import tempfile
+import threading
 import time
 import unittest
+from unittest.mock import patch
+import weakref
 
 import rclpy
+from rclpy.binary_log import format_record
+from rclpy.binary_log import read_binary_log
+from rclpy.impl.implementation_singleton import rclpy_logging_implementation as _rclpy_logging
+from rclpy.impl.rcutils_logger import CallerId
 from rclpy.logging import LoggingSeverity
 
 
@@ -78,6 +88,180 @@ class TestLogging(unittest.TestCase):
         self.assertTrue(rclpy.logging._root_logger.error('message_error'))
         self.assertTrue(rclpy.logging._root_logger.fatal('message_fatal'))
 
+    def test_log_level_cache(self):
+        logger = rclpy.logging.get_logger('my_cached_logger')
+        child = logger.get_child('child')
+        logger.set_level(LoggingSeverity.WARN)
+        self.assertFalse(child.info('message_info'))
+        self.assertFalse(child.is_enabled_for(LoggingSeverity.INFO))
+
+        # Setting the level of an ancestor invalidates the level cached by its descendants
+        generation = rclpy.logging._rclpy_logging.logger_level_generation
+        logger.set_level(LoggingSeverity.DEBUG)
+        self.assertNotEqual(generation, rclpy.logging._rclpy_logging.logger_level_generation)
+        self.assertTrue(child.is_enabled_for(LoggingSeverity.DEBUG))
+        self.assertTrue(child.debug('message_debug'))
+
+        rclpy.logging.set_logger_level('my_cached_logger.child', LoggingSeverity.ERROR)
+        self.assertFalse(child.warn('message_warn'))
+        rclpy.logging.clear_config()
+        self.assertTrue(child.error('message_error'))
+        self.assertEqual(
+            rclpy.logging._root_logger.get_effective_level() <= LoggingSeverity.WARN,
+            child.warn('message_warn'))
+
+    def test_caller_id(self):
+        caller_id, line_number = CallerId(), inspect.currentframe().f_lineno
+        self.assertEqual('test_caller_id', caller_id.function_name)
+        self.assertEqual(os.path.abspath(__file__), caller_id.file_path)
+        self.assertEqual(line_number, caller_id.line_number)
+        self.assertEqual(caller_id, CallerId(inspect.currentframe())._replace(
+            line_number=line_number, last_index=caller_id.last_index))
+
+        # Calls from different places of a line have different contexts
+        was_logged = [rclpy.logging._root_logger.fatal('message_once', once=True) for _ in '12']
+        was_logged.append(rclpy.logging._root_logger.fatal('message_once', once=True))
+        self.assertEqual([True, False, True], was_logged)
+
+    def test_caller_id_identical_code(self):
+        # Code objects of identical functions compare equal even if their files differ
+        source = (
+            'def log(logger):\n'
+            '    return CallerId(), logger.info(\'message_code\', once=True)\n')
+        functions = []
+        for file_name in ('first_node.py', 'second_node.py'):
+            namespace = {'CallerId': CallerId}
+            exec(compile(source, os.path.join(os.sep, 'tmp', file_name), 'exec'), namespace)
+            functions.append(namespace['log'])
+        self.assertEqual(functions[0].__code__, functions[1].__code__)
+
+        logger = rclpy.logging.get_logger('my_code_logger')
+        caller_ids = []
+        for function in functions:
+            caller_id, was_logged = function(logger)
+            caller_ids.append(caller_id)
+            self.assertTrue(was_logged)
+            self.assertFalse(function(logger)[1])
+        self.assertEqual(
+            [os.path.abspath(os.path.join(os.sep, 'tmp', file_name))
+             for file_name in ('first_node.py', 'second_node.py')],
+            [caller_id.file_path for caller_id in caller_ids])
+
+        # Logging does not keep the code objects alive
+        code = weakref.ref(functions[0].__code__)
+        del functions[:]
+        gc.collect()
+        self.assertIsNone(code())
+
+    def test_async_logging(self):
+        stats = rclpy.logging.get_async_stats()
+        rclpy.logging.enable_async(capacity=8)
+        try:
+            with self.assertRaises(RuntimeError):
+                rclpy.logging.enable_async()
+            for i in range(100):
+                self.assertTrue(rclpy.logging._root_logger.fatal('message_async_' + str(i)))
+        finally:
+            rclpy.logging.disable_async()
+        new_stats = rclpy.logging.get_async_stats()
+        self.assertEqual(0, new_stats['queued'])
+        self.assertEqual(
+            100,
+            new_stats['written'] - stats['written'] + new_stats['dropped'] - stats['dropped'])
+        self.assertGreater(new_stats['written'], stats['written'])
+
+        # Messages to loggers which are not enabled for their severity are not queued
+        rclpy.logging.set_logger_level('my_async_logger', LoggingSeverity.ERROR)
+        rclpy.logging.enable_async(capacity=8)
+        try:
+            self.assertTrue(
+                rclpy.logging._root_logger.info('message_async_filtered', name='my_async_logger'))
+        finally:
+            rclpy.logging.disable_async()
+        self.assertEqual(new_stats, rclpy.logging.get_async_stats())
+        rclpy.logging.disable_async()
+
+        # Concurrent calls return once the queued records are written
+        rclpy.logging.enable_async(capacity=1000)
+        for i in range(100):
+            rclpy.logging._root_logger.fatal('message_async_concurrent_' + str(i))
+        threads = [threading.Thread(target=rclpy.logging.disable_async) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        stats = rclpy.logging.get_async_stats()
+        self.assertEqual(0, stats['queued'])
+        self.assertEqual(
+            100,
+            stats['written'] - new_stats['written'] + stats['dropped'] - new_stats['dropped'])
+        rclpy.logging.enable_async(capacity=8)
+        rclpy.logging.disable_async()
+        with self.assertRaises(ValueError):
+            rclpy.logging.enable_async(capacity=0)
+
+    def test_logger_interning(self):
+        logger = rclpy.logging.get_logger('my_interned_logger')
+        self.assertIs(logger, rclpy.logging.get_logger('my_interned_logger'))
+        child = logger.get_child('child')
+        self.assertIs(child, logger.get_child('child'))
+        self.assertIs(child, rclpy.logging.get_logger('my_interned_logger.child'))
+        self.assertIsNot(child, logger.get_child('other'))
+
+        # Filter state is kept when the logger is got again for each call
+        for i in range(3):
+            logged = rclpy.logging.get_logger('my_interned_logger').get_child('child').info(
+                'message_test_logger_interning', once=True)
+            self.assertEqual(i == 0, logged)
+
+    def test_binary_output(self):
+        logger = rclpy.logging.get_logger('my_binary_logger')
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, 'log.bin')
+            rclpy.logging.enable_binary_output(path, 64 * 1024)
+            try:
+                with self.assertRaises(RuntimeError):
+                    rclpy.logging.enable_binary_output(path)
+                line_number = inspect.currentframe().f_lineno + 1
+                self.assertTrue(logger.warn('message_binary'))
+                self.assertTrue(logger.get_child('child').error('message_child'))
+                # Binary output stays enabled when the logging system is initialized again
+                rclpy.logging.initialize()
+                self.assertTrue(logger.error('message_initialized'))
+            finally:
+                rclpy.logging.disable_binary_output()
+            records = read_binary_log(path)
+            self.assertEqual(3, len(records))
+            self.assertEqual(
+                ['my_binary_logger', 'my_binary_logger.child', 'my_binary_logger'],
+                [r.name for r in records])
+            self.assertEqual(
+                ['message_binary', 'message_child', 'message_initialized'],
+                [r.message for r in records])
+            self.assertEqual(LoggingSeverity.WARN, records[0].severity)
+            self.assertEqual('test_binary_output', records[0].function_name)
+            self.assertEqual(os.path.abspath(__file__), records[0].file_name)
+            self.assertEqual(line_number, records[0].line_number)
+            self.assertLessEqual(records[0].timestamp, records[1].timestamp)
+            self.assertTrue(format_record(records[0]).startswith('[WARN] ['))
+            self.assertTrue(
+                format_record(records[0]).endswith('[my_binary_logger]: message_binary'))
+
+            # Once the file is full the oldest messages are overwritten
+            rclpy.logging.enable_binary_output(path, 64 * 1024)
+            try:
+                for i in range(2000):
+                    logger.warn('message_{:04d}_'.format(i) + 'x' * 40)
+            finally:
+                rclpy.logging.disable_binary_output()
+            messages = [r.message[:12] for r in read_binary_log(path)]
+            self.assertLess(len(messages), 2000)
+            self.assertEqual(
+                ['message_{:04d}'.format(i) for i in range(2000 - len(messages), 2000)],
+                messages)
+        with self.assertRaises(ValueError):
+            rclpy.logging.enable_binary_output(path, 1024)
+
     def test_log_once(self):
         message_was_logged = []
         for i in range(5):
@@ -200,14 +384,6 @@ class TestLogging(unittest.TestCase):
                     throttle_duration_sec=i,
                 )
 
-        with self.assertRaisesRegex(ValueError, 'name cannot be changed between'):
-            for i in range(2):
-                rclpy.logging._root_logger.log(
-                    'message_' + inspect.stack()[0][3] + '_' + str(i),
-                    LoggingSeverity.INFO,
-                    name='name_' + str(i),
-                )
-
         with self.assertRaisesRegex(ValueError, 'severity cannot be changed between'):
             for severity in LoggingSeverity:
                 rclpy.logging._root_logger.log(
@@ -215,6 +391,22 @@ class TestLogging(unittest.TestCase):
                     severity,
                 )
 
+    def test_log_name_changing(self):
+        # Each call logs with its own logger name, sharing the filters of the call site
+        logger = rclpy.logging.get_logger('my_changing_logger')
+        with patch.object(_rclpy_logging, 'rclpy_logging_rcutils_log') as rcutils_log:
+            for name in ('first_name', 'second_name', 'first_name', None):
+                kwargs = {} if name is None else {'name': name}
+                self.assertTrue(logger.fatal('message_name_changing', **kwargs))
+            self.assertEqual(
+                ['first_name', 'second_name', 'first_name', 'my_changing_logger'],
+                [call[0][1] for call in rcutils_log.call_args_list])
+
+            for name in ('first_name', 'second_name'):
+                self.assertEqual(
+                    name == 'first_name', logger.fatal('message_name_once', once=True, name=name))
+            self.assertEqual('first_name', rcutils_log.call_args[0][1])
+
     def test_named_logger(self):
         my_logger = rclpy.logging.get_logger('my_logger')
 
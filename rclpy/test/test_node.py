@@ -12,6 +12,9 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import os
+import tempfile
+import time
 import unittest
 from unittest.mock import Mock
 
@@ -21,7 +24,11 @@ import rclpy
 from rclpy.clock import ClockType
 from rclpy.exceptions import InvalidServiceNameException
 from rclpy.exceptions import InvalidTopicNameException
+from rclpy.executors import SingleThreadedExecutor
 from rclpy.parameter import Parameter
+from rclpy.publisher import PublishQueueOverflowPolicy
+from rclpy.subscription import MessageInfo
+from test_msgs.msg import Builtins
 from test_msgs.msg import Primitives
 
 TEST_NODE = 'my_node'
@@ -58,6 +65,70 @@ class TestNode(unittest.TestCase):
         with self.assertRaisesRegex(ValueError, 'unknown substitution'):
             self.node.create_publisher(Primitives, 'chatter/{bad_sub}')
 
+    def test_create_async_publisher(self):
+        pub = self.node.create_publisher(Primitives, 'chatter')
+        with self.assertRaises(RuntimeError):
+            pub.get_publish_queue_stats()
+        self.assertTrue(pub.publish(Primitives()))
+        with self.assertRaisesRegex(ValueError, 'at least 1'):
+            self.node.create_publisher(
+                Primitives, 'chatter', async_publish=True, publish_queue_size=0)
+        for policy in PublishQueueOverflowPolicy:
+            pub = self.node.create_publisher(
+                Primitives, 'chatter', async_publish=True, publish_queue_size=2,
+                overflow_policy=policy)
+            for i in range(100):
+                msg = Primitives()
+                msg.int32_value = i
+                pub.publish(msg)
+            stats = pub.get_publish_queue_stats()
+            self.assertEqual(2, stats['capacity'])
+            self.assertLessEqual(stats['size'], 2)
+            self.assertEqual(0, stats['failed'])
+            if policy == PublishQueueOverflowPolicy.BLOCK:
+                self.assertEqual(0, stats['dropped'])
+            self.assertTrue(self.node.destroy_publisher(pub))
+            self.assertEqual(0, pub.get_publish_queue_stats()['size'])
+            with self.assertRaisesRegex(RuntimeError, 'stopped'):
+                pub.publish(Primitives())
+
+    def test_async_publish_copies_message(self):
+        received = []
+        sub = self.node.create_subscription(
+            Primitives, 'async_chatter', lambda msg: received.append(msg.int32_value))
+        pub = self.node.create_publisher(
+            Primitives, 'async_chatter', async_publish=True, publish_queue_size=10)
+        executor = SingleThreadedExecutor(context=self.context)
+        executor.add_node(self.node)
+        try:
+            # Wait for the publisher and the subscription to be matched
+            msg = Primitives()
+            for _ in range(50):
+                pub.publish(msg)
+                executor.spin_once(timeout_sec=0.1)
+                if received:
+                    break
+            self.assertTrue(received)
+            for _ in range(10):
+                executor.spin_once(timeout_sec=0.01)
+            del received[:]
+
+            # Reusing the message does not change the messages still queued
+            for i in range(1, 6):
+                msg.int32_value = i
+                pub.publish(msg)
+            for _ in range(50):
+                executor.spin_once(timeout_sec=0.1)
+                if 5 in received:
+                    break
+        finally:
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_publisher(pub)
+            self.node.destroy_subscription(sub)
+        # Ignore late messages of the matching loop
+        self.assertEqual([1, 2, 3, 4, 5], [value for value in received if value])
+
     def test_create_subscription(self):
         self.node.create_subscription(Primitives, 'chatter', lambda msg: print(msg))
         with self.assertRaisesRegex(InvalidTopicNameException, 'must not contain characters'):
@@ -67,6 +138,172 @@ class TestNode(unittest.TestCase):
         with self.assertRaisesRegex(ValueError, 'unknown substitution'):
             self.node.create_subscription(Primitives, 'foo/{bad_sub}', lambda msg: print(msg))
 
+    def test_create_subscription_with_content_filter(self):
+        sub = self.node.create_subscription(
+            Primitives, 'chatter', lambda msg: print(msg), content_filter='int32_value % 2 == 0')
+        self.assertEqual('int32_value % 2 == 0', sub.content_filter)
+        self.assertIsNotNone(sub.content_filter_handle)
+        self.node.create_subscription(
+            Primitives, 'chatter', lambda msg: print(msg), content_filter="string_value != 'a'")
+        with self.assertRaisesRegex(ValueError, 'has no field'):
+            self.node.create_subscription(
+                Primitives, 'chatter', lambda msg: print(msg), content_filter='nope == 1')
+        with self.assertRaisesRegex(ValueError, 'can only be compared to a str'):
+            self.node.create_subscription(
+                Primitives, 'chatter', lambda msg: print(msg), content_filter='string_value == 1')
+        with self.assertRaisesRegex(ValueError, 'Modulus can only be applied'):
+            self.node.create_subscription(
+                Primitives, 'chatter', lambda msg: print(msg),
+                content_filter='float64_value % 2 == 0')
+
+    def test_take_with_content_filter(self):
+        received = []
+        sub = self.node.create_subscription(
+            Primitives, 'filtered_chatter', lambda msg: received.append(msg.int32_value),
+            content_filter='int32_value % 2 == 0')
+        pub = self.node.create_publisher(Primitives, 'filtered_chatter')
+        executor = SingleThreadedExecutor(context=self.context)
+        executor.add_node(self.node)
+        try:
+            for i in range(50):
+                pub.publish(Primitives(int32_value=i))
+                executor.spin_once(timeout_sec=0.1)
+                if len(received) >= 3:
+                    break
+            # Take the samples that are still pending
+            for _ in range(10):
+                executor.spin_once(timeout_sec=0.01)
+        finally:
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_publisher(pub)
+            self.node.destroy_subscription(sub)
+        self.assertGreaterEqual(len(received), 3)
+        self.assertEqual([], [value for value in received if value % 2])
+        self.assertEqual(sorted(received), received)
+
+    def test_take_with_uint64_content_filter(self):
+        # Values of uint64 fields above 2^63 are compared and reduced without a sign
+        values = [1, 2**63, 2**64 - 1, 5]
+        large = []
+        modulo = []
+        subs = [
+            self.node.create_subscription(
+                Primitives, 'uint64_chatter', lambda msg: large.append(msg.uint64_value),
+                content_filter='uint64_value >= 9223372036854775808'),
+            self.node.create_subscription(
+                Primitives, 'uint64_chatter', lambda msg: modulo.append(msg.uint64_value),
+                content_filter='uint64_value % 10 == 8'),
+        ]
+        pub = self.node.create_publisher(Primitives, 'uint64_chatter')
+        executor = SingleThreadedExecutor(context=self.context)
+        executor.add_node(self.node)
+        try:
+            for i in range(50):
+                pub.publish(Primitives(uint64_value=values[i % len(values)]))
+                executor.spin_once(timeout_sec=0.1)
+                if len(large) >= 2 and modulo:
+                    break
+            for _ in range(10):
+                executor.spin_once(timeout_sec=0.01)
+        finally:
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_publisher(pub)
+            for sub in subs:
+                self.node.destroy_subscription(sub)
+        self.assertTrue({2**63, 2**64 - 1}.issuperset(large))
+        self.assertGreaterEqual(len(large), 2)
+        self.assertTrue(modulo)
+        self.assertEqual({2**63}, set(modulo))
+
+    def test_create_subscription_keep_latest(self):
+        sub = self.node.create_subscription(Primitives, 'chatter', lambda msg: print(msg))
+        self.assertFalse(sub.keep_latest)
+        sub = self.node.create_subscription(
+            Primitives, 'chatter', lambda msg: print(msg), keep_latest=True)
+        self.assertTrue(sub.keep_latest)
+
+    def test_take_keep_latest(self):
+        received = []
+        sub = self.node.create_subscription(
+            Primitives, 'latest_chatter', lambda msg: received.append(msg.int32_value),
+            keep_latest=True)
+        pub = self.node.create_publisher(Primitives, 'latest_chatter')
+        executor = SingleThreadedExecutor(context=self.context)
+        executor.add_node(self.node)
+        try:
+            # Wait for the publisher and the subscription to be matched
+            for _ in range(50):
+                pub.publish(Primitives(int32_value=0))
+                executor.spin_once(timeout_sec=0.1)
+                if received:
+                    break
+            self.assertTrue(received)
+            for _ in range(10):
+                executor.spin_once(timeout_sec=0.01)
+            del received[:]
+
+            # All the samples pending when the subscription is taken from give one callback
+            for i in range(1, 6):
+                pub.publish(Primitives(int32_value=i))
+            time.sleep(0.5)
+            for _ in range(10):
+                executor.spin_once(timeout_sec=0.1)
+        finally:
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_publisher(pub)
+            self.node.destroy_subscription(sub)
+        self.assertEqual([5], received)
+
+    def test_create_subscription_with_latency_tracking(self):
+        sub = self.node.create_subscription(
+            Builtins, 'builtins', lambda msg: print(msg), track_latency='time_value')
+        stats = sub.get_latency_stats()
+        self.assertEqual(0, stats['count'])
+        self.assertIsNone(stats['min_ns'])
+        self.assertIsNone(stats['buckets'][-1][0])
+        sub.reset_latency_stats()
+        sub = self.node.create_subscription(Builtins, 'builtins', lambda msg: print(msg))
+        with self.assertRaises(RuntimeError):
+            sub.get_latency_stats()
+        with self.assertRaisesRegex(ValueError, 'has no field'):
+            self.node.create_subscription(
+                Primitives, 'chatter', lambda msg: print(msg), track_latency=True)
+        with self.assertRaisesRegex(ValueError, 'is not a builtin_interfaces/Time'):
+            self.node.create_subscription(
+                Primitives, 'chatter', lambda msg: print(msg), track_latency='int32_value')
+
+    def test_take_message_info_and_latency(self):
+        received = []
+        sub = self.node.create_subscription(
+            Builtins, 'latency_chatter', lambda msg, info: received.append((msg, info)),
+            message_info=True, track_latency='time_value')
+        pub = self.node.create_publisher(Builtins, 'latency_chatter')
+        executor = SingleThreadedExecutor(context=self.context)
+        executor.add_node(self.node)
+        try:
+            for _ in range(50):
+                msg = Builtins()
+                msg.time_value = self.node.get_clock().now().to_msg()
+                pub.publish(msg)
+                executor.spin_once(timeout_sec=0.1)
+                if received:
+                    break
+        finally:
+            self.node.executor = None
+            executor.shutdown()
+            self.node.destroy_publisher(pub)
+            self.node.destroy_subscription(sub)
+        self.assertTrue(received)
+        self.assertIsInstance(received[0][1], MessageInfo)
+        self.assertIsInstance(received[0][1].publisher_gid, bytes)
+        stats = sub.get_latency_stats()
+        self.assertGreaterEqual(stats['count'] + stats['negative_count'], 1)
+        self.assertEqual(
+            stats['count'], sum(count for _, count in stats['buckets']))
+
     def test_create_client(self):
         self.node.create_client(GetParameters, 'get/parameters')
         with self.assertRaisesRegex(InvalidServiceNameException, 'must not contain characters'):
@@ -198,6 +435,71 @@ class TestNode(unittest.TestCase):
         with self.assertRaises(TypeError):
             self.node.set_parameters([42])
 
+    def test_node_set_parameters_single_event(self):
+        publisher = self.node._parameter_event_publisher
+        self.node._parameter_event_publisher = Mock()
+        try:
+            self.node.set_parameters([
+                Parameter('event_int', Parameter.Type.INTEGER, 1),
+                Parameter('event_str', Parameter.Type.STRING, 'hello'),
+            ])
+            self.node.set_parameters([
+                Parameter('event_int', Parameter.Type.INTEGER, 2),
+                Parameter('event_str', Parameter.Type.NOT_SET, None),
+                Parameter('event_double', Parameter.Type.DOUBLE, 2.41),
+            ])
+            self.node.set_parameters([])
+            calls = self.node._parameter_event_publisher.publish.call_args_list
+            self.assertEqual(2, len(calls))
+            first, second = calls[0][0][0], calls[1][0][0]
+            self.assertEqual(
+                ['event_int', 'event_str'], [p.name for p in first.new_parameters])
+            self.assertEqual(['event_double'], [p.name for p in second.new_parameters])
+            self.assertEqual(['event_int'], [p.name for p in second.changed_parameters])
+            self.assertEqual(2, second.changed_parameters[0].value.integer_value)
+            self.assertEqual(['event_str'], [p.name for p in second.deleted_parameters])
+        finally:
+            self.node._parameter_event_publisher = publisher
+
+    def test_node_parameter_handle(self):
+        gain = self.node.parameter_handle('handle_gain', float)
+        self.assertIs(gain, self.node.parameter_handle('handle_gain'))
+        self.assertIs(gain, self.node.parameter_handle('handle_gain', Parameter.Type.DOUBLE))
+        self.assertIsNone(gain.value)
+        version = gain.version
+
+        self.node.set_parameters([Parameter('handle_gain', Parameter.Type.DOUBLE, 0.5)])
+        self.assertEqual(0.5, gain.value)
+        self.assertGreater(gain.version, version)
+        version = gain.version
+
+        # Changes of other parameters and values of the wrong type leave the handle alone
+        self.node.set_parameters([Parameter('handle_other', Parameter.Type.DOUBLE, 1.5)])
+        result = self.node.set_parameters_atomically([
+            Parameter('handle_other', Parameter.Type.DOUBLE, 2.5),
+            Parameter('handle_gain', Parameter.Type.INTEGER, 1),
+        ])
+        self.assertFalse(result.successful)
+        self.assertEqual(1.5, self.node.get_parameter('handle_other').value)
+        self.assertEqual(0.5, gain.value)
+        self.assertEqual(version, gain.version)
+
+        self.node.set_parameters([Parameter('handle_gain', Parameter.Type.NOT_SET, None)])
+        self.assertIsNone(gain.value)
+        self.assertGreater(gain.version, version)
+
+        with self.assertRaises(TypeError):
+            self.node.parameter_handle('handle_gain', int)
+        with self.assertRaises(TypeError):
+            self.node.parameter_handle('handle_other', str)
+        with self.assertRaises(TypeError):
+            self.node.parameter_handle('handle_list', list)
+        other = self.node.parameter_handle('handle_other')
+        self.assertEqual(1.5, other.value)
+        self.assertIs(other, self.node.parameter_handle('handle_other', float))
+        self.assertFalse(self.node.set_parameters([
+            Parameter('handle_other', Parameter.Type.STRING, 'hello')])[0].successful)
+
     def test_node_set_parameters_atomically(self):
         result = self.node.set_parameters_atomically([
             Parameter('foo', Parameter.Type.INTEGER, 42),
@@ -275,6 +577,74 @@ class TestCreateNode(unittest.TestCase):
         finally:
             rclpy.shutdown(context=context)
 
+    def test_parameter_event_window(self):
+        context = rclpy.context.Context()
+        rclpy.init(context=context)
+        try:
+            node = rclpy.create_node(
+                'my_node', context=context, parameter_event_window_sec=60.0,
+                initial_parameters=[Parameter('initial', Parameter.Type.INTEGER, 1)])
+            node._parameter_event_timer.callback()
+            node._parameter_event_publisher = Mock()
+            node.set_parameters([Parameter('changed', Parameter.Type.INTEGER, 1)])
+            node.set_parameters_atomically([Parameter('changed', Parameter.Type.INTEGER, 2)])
+            node.set_parameters([Parameter('initial', Parameter.Type.NOT_SET, None)])
+            node.set_parameters([Parameter('transient', Parameter.Type.INTEGER, 1)])
+            node.set_parameters([Parameter('transient', Parameter.Type.NOT_SET, None)])
+            node._parameter_event_publisher.publish.assert_not_called()
+            # Changes made within the window are published together when it ends
+            node._parameter_event_timer.callback()
+            node._parameter_event_publisher.publish.assert_called_once()
+            event = node._parameter_event_publisher.publish.call_args[0][0]
+            self.assertEqual(['changed'], [p.name for p in event.new_parameters])
+            self.assertEqual(2, event.new_parameters[0].value.integer_value)
+            self.assertEqual([], list(event.changed_parameters))
+            self.assertEqual(['initial'], [p.name for p in event.deleted_parameters])
+            node._parameter_event_timer.callback()
+            node._parameter_event_publisher.publish.assert_called_once()
+            node.destroy_node()
+            with self.assertRaises(ValueError):
+                rclpy.create_node('my_node', context=context, parameter_event_window_sec=0)
+        finally:
+            rclpy.shutdown(context=context)
+
+    def test_params_file_parsed_once(self):
+        with tempfile.NamedTemporaryFile('w', suffix='.yaml', delete=False) as params_file:
+            params_file.write(
+                'my_ns:\n'
+                '  my_node:\n'
+                '    ros__parameters:\n'
+                '      int_param: 42\n'
+                '  other_node:\n'
+                '    ros__parameters:\n'
+                '      int_param: 7\n')
+        context = rclpy.context.Context()
+        rclpy.init(args=['process_name', '__params:=' + params_file.name], context=context)
+        try:
+            node1 = rclpy.create_node('my_node', namespace='/my_ns', context=context)
+            node2 = rclpy.create_node('my_node', namespace='/my_ns', context=context)
+            node3 = rclpy.create_node('other_node', namespace='/my_ns', context=context)
+            self.assertEqual(42, node1.get_parameter('int_param').value)
+            self.assertEqual(42, node2.get_parameter('int_param').value)
+            self.assertEqual(7, node3.get_parameter('int_param').value)
+            self.assertEqual([params_file.name], list(context._param_files))
+            # Both nodes got their parameters from the same parse of the file
+            self.assertIs(
+                node1.get_parameter('int_param'), node2.get_parameter('int_param'))
+            parsed = context._param_files[params_file.name]
+            # A modified file is parsed again
+            with open(params_file.name, 'a') as f:
+                f.write('      double_param: 1.5\n')
+            os.utime(params_file.name, ns=(0, parsed[0] + 1))
+            node4 = rclpy.create_node('other_node', namespace='/my_ns', context=context)
+            self.assertEqual(1.5, node4.get_parameter('double_param').value)
+            self.assertIsNot(parsed, context._param_files[params_file.name])
+            for node in (node1, node2, node3, node4):
+                node.destroy_node()
+        finally:
+            rclpy.shutdown(context=context)
+            os.unlink(params_file.name)
+
 
 if __name__ == '__main__':
     unittest.main()
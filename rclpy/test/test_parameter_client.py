@@ -0,0 +1,94 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import time
+import unittest
+
+import rclpy
+from rclpy.executors import SingleThreadedExecutor
+from rclpy.parameter import Parameter
+from rclpy.parameter_client import CachedParameterClient
+
+
+class TestCachedParameterClient(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.context = rclpy.context.Context()
+        rclpy.init(context=cls.context)
+        cls.remote_node = rclpy.create_node(
+            'remote_node', namespace='/test_ns', context=cls.context,
+            initial_parameters=[
+                Parameter('int_param', Parameter.Type.INTEGER, 1),
+                Parameter('string_param', Parameter.Type.STRING, 'hello'),
+            ])
+        cls.node = rclpy.create_node('TestCachedParameterClient', context=cls.context)
+        cls.executor = SingleThreadedExecutor(context=cls.context)
+        cls.executor.add_node(cls.remote_node)
+        cls.executor.add_node(cls.node)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.executor.shutdown()
+        cls.node.destroy_node()
+        cls.remote_node.destroy_node()
+        rclpy.shutdown(context=cls.context)
+
+    def spin_until(self, condition, timeout_sec=5.0):
+        end = time.monotonic() + timeout_sec
+        while not condition() and time.monotonic() < end:
+            self.executor.spin_once(timeout_sec=0.1)
+        return condition()
+
+    def test_mirror(self):
+        client = CachedParameterClient(self.node, '/test_ns/remote_node')
+        try:
+            self.assertEqual('/test_ns/remote_node', client.remote_node_name)
+            self.assertTrue(client.wait_for_services(timeout_sec=5.0))
+            self.assertFalse(client.is_ready())
+            future = client.refresh()
+            self.assertTrue(self.spin_until(future.done))
+            self.assertTrue(future.result())
+            self.assertTrue(client.is_ready())
+            self.assertEqual(
+                {'int_param', 'string_param'}, set(client.get_parameter_names()))
+            self.assertEqual(
+                [1, 'hello'],
+                [p.value for p in client.get_parameters(['int_param', 'string_param'])])
+            self.assertEqual(Parameter.Type.NOT_SET, client.get_parameter('unknown').type_)
+
+            self.remote_node.set_parameters([
+                Parameter('int_param', Parameter.Type.INTEGER, 2),
+                Parameter('string_param', Parameter.Type.NOT_SET, None),
+                Parameter('double_param', Parameter.Type.DOUBLE, 2.5),
+            ])
+            self.assertTrue(self.spin_until(
+                lambda: client.get_parameter('double_param').value == 2.5))
+            self.assertEqual(2, client.get_parameter('int_param').value)
+            self.assertEqual(Parameter.Type.NOT_SET, client.get_parameter('string_param').type_)
+
+            # Events of other nodes in the namespace are ignored
+            other_node = rclpy.create_node(
+                'other_node', namespace='/test_ns', context=self.context,
+                initial_parameters=[Parameter('int_param', Parameter.Type.INTEGER, 3)])
+            other_node.set_parameters([Parameter('int_param', Parameter.Type.INTEGER, 4)])
+            self.spin_until(lambda: False, timeout_sec=0.5)
+            self.assertEqual(2, client.get_parameter('int_param').value)
+            other_node.destroy_node()
+        finally:
+            client.destroy()
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,81 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+from rclpy.parameter_index import ParameterIndex
+
+
+class TestParameterIndex(unittest.TestCase):
+
+    def setUp(self):
+        self.index = ParameterIndex()
+        for name in ('foo', 'bar', 'foo.x', 'foo.y', 'foo.sub.z', 'baz.w'):
+            self.index.add(name)
+
+    def test_add_remove(self):
+        self.assertEqual(6, len(self.index))
+        self.index.add('foo.x')
+        self.assertEqual(6, len(self.index))
+        self.assertIn('foo.sub.z', self.index)
+        self.assertNotIn('foo.sub', self.index)
+
+        self.index.remove('foo.sub.z')
+        self.index.remove('foo.sub.z')
+        self.index.remove('not.there')
+        self.assertEqual(5, len(self.index))
+        self.assertNotIn('foo.sub.z', self.index)
+        names, prefixes = self.index.list(['foo'])
+        self.assertNotIn('foo.sub', prefixes)
+
+    def test_list_all(self):
+        names, prefixes = self.index.list()
+        self.assertEqual(
+            {'foo', 'bar', 'foo.x', 'foo.y', 'foo.sub.z', 'baz.w'}, set(names))
+        self.assertEqual({'foo', 'foo.sub', 'baz'}, set(prefixes))
+
+    def test_list_depth(self):
+        names, prefixes = self.index.list(depth=1)
+        self.assertEqual({'foo', 'bar'}, set(names))
+        self.assertEqual([], prefixes)
+
+        names, prefixes = self.index.list(depth=2)
+        self.assertEqual({'foo', 'bar', 'foo.x', 'foo.y', 'baz.w'}, set(names))
+        self.assertEqual({'foo', 'baz'}, set(prefixes))
+
+    def test_list_prefixes(self):
+        names, prefixes = self.index.list(['foo'])
+        self.assertEqual({'foo.x', 'foo.y', 'foo.sub.z'}, set(names))
+        self.assertEqual({'foo', 'foo.sub'}, set(prefixes))
+
+        names, prefixes = self.index.list(['foo', 'foo.sub'])
+        self.assertEqual(3, len(names))
+
+        names, prefixes = self.index.list(['foo'], depth=2)
+        self.assertEqual({'foo.x', 'foo.y'}, set(names))
+
+        self.assertEqual(([], []), self.index.list(['fo']))
+        self.assertEqual(([], []), self.index.list(['foo'], depth=1))
+
+    def test_many_parameters(self):
+        index = ParameterIndex()
+        for i in range(20000):
+            index.add('calibration.camera_{0}.param_{1}'.format(i // 100, i % 100))
+        names, prefixes = index.list(['calibration.camera_7'])
+        self.assertEqual(100, len(names))
+        self.assertEqual({'calibration.camera_7'}, set(prefixes))
+
+
+if __name__ == '__main__':
+    unittest.main()
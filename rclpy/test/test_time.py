@@ -12,6 +12,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import copy
+import pickle
 import unittest
 
 from rclpy.clock import ClockType
@@ -101,6 +103,20 @@ class TestTime(unittest.TestCase):
         # Subtraction resulting in a negative duration
         assert (Time(nanoseconds=1) - Time(nanoseconds=2)).nanoseconds == -1
 
+        # Subtraction resulting in a duration too large to store
+        with self.assertRaises(OverflowError):
+            Time(nanoseconds=2**64 - 1) - Time(nanoseconds=0)
+        diff = Time(nanoseconds=0) - Time(nanoseconds=2**63)
+        assert diff.nanoseconds == -2**63
+
+        # Arithmetic with negative durations
+        assert (Time(nanoseconds=3) + Duration(nanoseconds=-2)).nanoseconds == 1
+        assert (Time(nanoseconds=3) - Duration(nanoseconds=-2)).nanoseconds == 5
+        with self.assertRaises(ValueError):
+            Time(nanoseconds=1) + Duration(nanoseconds=-2)
+        with self.assertRaises(OverflowError):
+            Time(nanoseconds=2**64 - 1) - Duration(nanoseconds=-1)
+
         # Subtraction of times with different clock types
         with self.assertRaises(TypeError):
             Time(nanoseconds=2, clock_type=ClockType.SYSTEM_TIME) - \
@@ -218,3 +234,18 @@ class TestTime(unittest.TestCase):
         assert (1, int(5e8)) == Time(seconds=1, nanoseconds=5e8).seconds_nanoseconds()
         assert (1, int(5e8)) == Time(seconds=0, nanoseconds=15e8).seconds_nanoseconds()
         assert (0, 0) == Time().seconds_nanoseconds()
+
+    def test_copy_and_pickle(self):
+        time = Time(nanoseconds=123, clock_type=ClockType.STEADY_TIME)
+        duration = Duration(nanoseconds=-456)
+        for copied_time in (
+            copy.copy(time), copy.deepcopy(time), pickle.loads(pickle.dumps(time))
+        ):
+            assert isinstance(copied_time, Time)
+            assert copied_time == time
+            assert copied_time.clock_type == ClockType.STEADY_TIME
+        for copied_duration in (
+            copy.copy(duration), copy.deepcopy(duration), pickle.loads(pickle.dumps(duration))
+        ):
+            assert isinstance(copied_duration, Duration)
+            assert copied_duration == duration
@@ -144,6 +144,22 @@ class TestTimeSource(unittest.TestCase):
         assert time_source._node == node2
         assert time_source._clock_sub is not None
 
+    def test_clock_callback_updates_all_clocks(self):
+        time_source = TimeSource(node=self.node)
+        clocks = [ROSClock() for i in range(3)]
+        for clock in clocks:
+            time_source.attach_clock(clock)
+        time_source.ros_time_is_active = True
+
+        time_source.clock_callback(builtin_interfaces.msg.Time(sec=2, nanosec=5))
+        for clock in clocks:
+            assert clock.now() == Time(seconds=2, nanoseconds=5, clock_type=ClockType.ROS_TIME)
+
+        # Clocks attached later start from the last time received
+        clock = ROSClock()
+        time_source.attach_clock(clock)
+        assert clock.now() == Time(seconds=2, nanoseconds=5, clock_type=ClockType.ROS_TIME)
+
     def test_forwards_jump(self):
         time_source = TimeSource(node=self.node)
         clock = ROSClock()
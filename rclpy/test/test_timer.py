@@ -16,6 +16,7 @@ import multiprocessing
 import os
 import platform
 import sys
+import threading
 import time
 import traceback
 from unittest.case import SkipTest
@@ -23,7 +24,10 @@ from unittest.case import SkipTest
 import pytest
 
 import rclpy
+from rclpy.clock import ClockType
+from rclpy.clock import ROSClock
 from rclpy.executors import SingleThreadedExecutor
+from rclpy.time import Time
 
 
 def run_catch_report_raise(func, *args, **kwargs):
@@ -197,3 +201,46 @@ def test_timer_cancel_reset_1000hertz():
         raise SkipTest
     func_launch(
         func_cancel_reset_timer, ['0.001'], "didn't receive the expected number of callbacks")
+
+
+def func_ros_time_timer(args):
+    context = rclpy.context.Context()
+    rclpy.init(context=context)
+    node = rclpy.create_node('test_ros_time_timer', context=context)
+    executor = SingleThreadedExecutor(context=context)
+    executor.add_node(node)
+    executor.spin_once(timeout_sec=0)
+
+    clock = ROSClock()
+    clock._set_ros_time_is_active(True)
+    clock.set_ros_time_override(Time(seconds=1, clock_type=ClockType.ROS_TIME))
+    callbacks = []
+    timer = node.create_timer(10.0, lambda: callbacks.append(clock.now()), clock=clock)
+    assert timer.clock is clock
+
+    # Wall time passing does not advance a timer on ROS time
+    executor.spin_once(timeout_sec=0.2)
+    assert [] == callbacks
+
+    # Advancing the clock past the deadline wakes the executor without waiting for the timeout
+    advance = threading.Timer(0.1, lambda: clock.set_ros_time_override(
+        Time(seconds=11, clock_type=ClockType.ROS_TIME)))
+    advance.start()
+    begin_time = time.time()
+    while rclpy.ok(context=context) and not callbacks and time.time() - begin_time < 5:
+        executor.spin_once(timeout_sec=5)
+    advance.join()
+    assert time.time() - begin_time < 2.5
+    assert [Time(seconds=11, clock_type=ClockType.ROS_TIME)] == callbacks
+
+    node.destroy_timer(timer)
+    # The clock belongs to the caller and remains usable
+    assert clock.now() == Time(seconds=11, clock_type=ClockType.ROS_TIME)
+    executor.shutdown()
+    rclpy.shutdown(context=context)
+
+    return True
+
+
+def test_timer_ros_time():
+    func_launch(func_ros_time_timer, [], "didn't receive the expected ROS time callback")